@@ -270,7 +270,7 @@ void CraftEquipmentState::init()
 				// now that we're back from the inventory screen, we need to remove all the excess base gear
 				for (_sel = 0; _sel != _items.size(); ++_sel)
 				{
-					int excessQty = c->getItems()->getItem(_items[_sel]) - (c->getExtraItems()->getItem(_items[_sel]) + c->getSoldierItems()->getItem(_items[_sel]));
+					int excessQty = c->getItems()->getItem(_items[_sel], _game->getMod()) - (c->getExtraItems()->getItem(_items[_sel], _game->getMod()) + c->getSoldierItems()->getItem(_items[_sel], _game->getMod()));
 					moveLeftByValue(excessQty);
 				}
 			}
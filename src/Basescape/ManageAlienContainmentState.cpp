@@ -347,7 +347,7 @@ void ManageAlienContainmentState::dealWithSelectedAliens(bool sell)
 		if (_qtys[i] > 0)
 		{
 			// remove the aliens
-			_base->getStorageItems()->removeItem(_aliens[i], _qtys[i]);
+			_base->getStorageItems()->removeItem(_aliens[i], _qtys[i], _game->getMod());
 
 			if (sell)
 			{
@@ -540,7 +540,7 @@ void ManageAlienContainmentState::lstItemsMousePress(Action *action)
  */
 int ManageAlienContainmentState::getQuantity()
 {
-	return _base->getStorageItems()->getItem(_aliens[_sel]);
+	return _base->getStorageItems()->getItem(_aliens[_sel], _game->getMod());
 }
 
 /**
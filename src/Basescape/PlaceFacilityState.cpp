@@ -265,7 +265,7 @@ void PlaceFacilityState::viewClick(Action *)
 		{
 			for (const auto& item: _rule->getBuildCostItems())
 			{
-				int needed = item.second.first - _base->getStorageItems()->getItem(item.first);
+				int needed = item.second.first - _base->getStorageItems()->getItem(item.first, _game->getMod());
 				if (needed > 0)
 				{
 					_game->popState();
@@ -351,7 +351,7 @@ void PlaceFacilityState::viewClick(Action *)
 			_game->getSavedGame()->setFunds(_game->getSavedGame()->getFunds() - _rule->getBuildCost());
 			for (const auto& item: _rule->getBuildCostItems())
 			{
-				_base->getStorageItems()->removeItem(item.first, item.second.first);
+				_base->getStorageItems()->removeItem(item.first, item.second.first, _game->getMod());
 			}
 			if (!_game->isShiftPressed())
 			{
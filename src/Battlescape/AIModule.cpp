@@ -30,6 +30,7 @@
 #include "../Engine/RNG.h"
 #include "../Engine/Logger.h"
 #include "../Engine/Game.h"
+#include "../Engine/Profiler.h"
 #include "../Mod/Armor.h"
 #include "../Mod/Mod.h"
 #include "../Mod/RuleItem.h"
@@ -207,6 +208,7 @@ void AIModule::dont_think(BattleAction *action)
  */
 void AIModule::think(BattleAction *action)
 {
+	ProfileScope profile("AIModule::think");
 	action->type = BA_RETHINK;
 	action->actor = _unit;
 	action->weapon = _unit->getMainHandWeapon(false);
@@ -2906,6 +2908,7 @@ bool AIModule::visibleToAnyFriend(BattleUnit* target) const
 
 void AIModule::brutalThink(BattleAction* action)
 {
+	ProfileScope profile("AIModule::brutalThink");
 	// Step 1: Check whether we wait for someone else on our team to move first
 	int myReachable = getReachableBy(_unit, _ranOutOfTUs, true).size();
 	float myDist = 0;
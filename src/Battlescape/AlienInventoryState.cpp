@@ -157,49 +157,13 @@ AlienInventoryState::AlienInventoryState(BattleUnit *unit)
 		}
 		else
 		{
-			const std::string look = s->getArmor()->getSpriteInventory();
-			const std::string gender = s->getGender() == GENDER_MALE ? "M" : "F";
-			std::stringstream ss;
-			Surface *surf = 0;
-
-			for (int i = 0; i <= RuleSoldier::LookVariantBits; ++i)
-			{
-				ss.str("");
-				ss << look;
-				ss << gender;
-				ss << (int)s->getLook() + (s->getLookVariant() & (RuleSoldier::LookVariantMask >> i)) * 4;
-				ss << ".SPK";
-				surf = _game->getMod()->getSurface(ss.str(), false);
-				if (surf)
-				{
-					break;
-				}
-			}
-			if (!surf)
-			{
-				ss.str("");
-				ss << look;
-				ss << ".SPK";
-				surf = _game->getMod()->getSurface(ss.str(), false);
-			}
-			if (!surf)
-			{
-				surf = _game->getMod()->getSurface(look, true);
-			}
+			Surface *surf = _game->getMod()->getFirstSurface(s->getSpriteInventoryNames(s->getArmor()->getSpriteInventory()));
 			surf->blitNShade(_soldier, 0, 0);
 		}
 	}
 	else
 	{
-		Surface *armorSurface = _game->getMod()->getSurface(unit->getArmor()->getSpriteInventory(), false);
-		if (!armorSurface)
-		{
-			armorSurface = _game->getMod()->getSurface(unit->getArmor()->getSpriteInventory() + ".SPK", false);
-		}
-		if (!armorSurface)
-		{
-			armorSurface = _game->getMod()->getSurface(unit->getArmor()->getSpriteInventory() + "M0.SPK", false);
-		}
+		Surface *armorSurface = _game->getMod()->getFirstSurface(unit->getArmor()->getSpriteInventoryNames(), false);
 		if (armorSurface)
 		{
 			armorSurface->blitNShade(_soldier, 0, 0);
@@ -0,0 +1,389 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "BattlescapeBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <iomanip>
+#include "Map.h"
+#include "Camera.h"
+#include "TileEngine.h"
+#include "Pathfinding.h"
+#include "PathfindingNode.h"
+#include "AIModule.h"
+#include "../Engine/Game.h"
+#include "../Engine/Surface.h"
+#include "../Engine/SurfaceSet.h"
+#include "../Engine/Script.h"
+#include "../Engine/Options.h"
+#include "../Engine/CrossPlatform.h"
+#include "../Engine/Logger.h"
+#include "../Mod/Mod.h"
+#include "../Mod/Armor.h"
+#include "../Mod/RuleItem.h"
+#include "../Savegame/SavedBattleGame.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/Tile.h"
+#include "../version.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Most units taking part, the pair kernels grow with its square.
+const size_t MAX_UNITS = 16;
+/// Radius of the area around each unit rated by the cover kernel.
+const int COVER_RADIUS = 5;
+/// Times each unit sprite is recolored by the script kernels.
+const int BLIT_REPEAT = 64;
+
+}
+
+/**
+ * Picks the units and path targets used by the kernels.
+ * @param game Pointer to the core game.
+ * @param save Pointer to the battle being measured.
+ * @param map Pointer to the battlescape map.
+ * @param runs Number of timed runs of every kernel.
+ */
+BattlescapeBenchmark::BattlescapeBenchmark(Game *game, SavedBattleGame *save, Map *map, int runs) : _game(game), _save(save), _map(map), _runs(std::max(runs, 1))
+{
+	for (auto* unit : *_save->getUnits())
+	{
+		if (!unit->isOut() && unit->getTile() && _units.size() < MAX_UNITS)
+		{
+			_units.push_back(unit);
+		}
+	}
+	// path targets are free floor tiles next to the units, a tile taken by a unit can't be reached
+	for (auto* unit : _units)
+	{
+		for (int dir = 0; dir < 8; ++dir)
+		{
+			Position offset;
+			Pathfinding::directionToVector(dir, &offset);
+			Position pos = unit->getPosition() + offset;
+			Tile *tile = _save->getTile(pos);
+			if (tile && !tile->getUnit() && !tile->hasNoFloor(_save))
+			{
+				_targets.push_back(pos);
+				break;
+			}
+		}
+	}
+}
+
+/**
+ * Runs the kernel once to warm up, then times it for every run.
+ * @param name Name of the kernel in the report.
+ * @param kernel Function doing the work and returning the number of operations.
+ */
+void BattlescapeBenchmark::measure(const std::string &name, const std::function<int()> &kernel)
+{
+	Result result;
+	result.name = name;
+	result.ops = kernel();
+	for (int i = 0; i < _runs; ++i)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		int ops = kernel();
+		const auto end = std::chrono::steady_clock::now();
+		double seconds = std::chrono::duration<double>(end - start).count();
+		result.opsPerSecond.push_back(seconds > 0 ? ops / seconds : 0);
+	}
+
+	std::vector<double> sorted = result.opsPerSecond;
+	std::sort(sorted.begin(), sorted.end());
+	Log(LOG_INFO) << "Benchmark " << name << ": " << std::fixed << std::setprecision(1) << sorted[sorted.size() / 2] << " ops/s median, "
+		<< sorted.front() << " min, " << sorted.back() << " max (" << result.ops << " ops per run)";
+	_results.push_back(result);
+}
+
+/**
+ * Times a kernel once, without warming up. Used for kernels that
+ * change the battle, as repeated runs would not measure the same work.
+ * @param name Name of the kernel in the report.
+ * @param kernel Function doing the work and returning the number of operations.
+ */
+void BattlescapeBenchmark::measureOnce(const std::string &name, const std::function<int()> &kernel)
+{
+	Result result;
+	result.name = name;
+	const auto start = std::chrono::steady_clock::now();
+	result.ops = kernel();
+	const auto end = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+	result.opsPerSecond.push_back(seconds > 0 ? result.ops / seconds : 0);
+
+	Log(LOG_INFO) << "Benchmark " << name << ": " << std::fixed << std::setprecision(1) << result.opsPerSecond.front() << " ops/s, single run ("
+		<< result.ops << " ops)";
+	_results.push_back(result);
+}
+
+/**
+ * Writes the runs and statistics of every kernel to a JSON file.
+ * @param filename Full path of the file.
+ * @return True if the file was written.
+ */
+bool BattlescapeBenchmark::exportJson(const std::string &filename) const
+{
+	std::ostringstream ss;
+	ss << std::fixed << std::setprecision(3);
+	ss << "{\"version\":\"" << OPENXCOM_VERSION_SHORT << OPENXCOM_VERSION_GIT << "\",";
+	ss << "\"save\":\"" << Options::getLoadThisSave() << "\",";
+	ss << "\"runs\":" << _runs << ",\"units\":" << _units.size() << ",\"kernels\":[";
+	for (size_t i = 0; i < _results.size(); ++i)
+	{
+		const Result &result = _results[i];
+		std::vector<double> sorted = result.opsPerSecond;
+		std::sort(sorted.begin(), sorted.end());
+		double mean = 0, variance = 0;
+		for (double v : sorted)
+		{
+			mean += v;
+		}
+		mean /= sorted.size();
+		for (double v : sorted)
+		{
+			variance += (v - mean) * (v - mean);
+		}
+		variance /= sorted.size();
+
+		if (i > 0)
+		{
+			ss << ",";
+		}
+		ss << "{\"name\":\"" << result.name << "\",\"ops\":" << result.ops << ",\"opsPerSecond\":[";
+		for (size_t j = 0; j < result.opsPerSecond.size(); ++j)
+		{
+			ss << (j > 0 ? "," : "") << result.opsPerSecond[j];
+		}
+		ss << "],\"median\":" << sorted[sorted.size() / 2] << ",\"mean\":" << mean << ",\"min\":" << sorted.front()
+			<< ",\"max\":" << sorted.back() << ",\"stddev\":" << std::sqrt(variance) << "}";
+	}
+	ss << "]}\n";
+	return CrossPlatform::writeFile(filename, ss.str());
+}
+
+/**
+ * Times every kernel and writes the report.
+ * The explosion kernel damages the battle, so it goes last and runs once.
+ */
+void BattlescapeBenchmark::run()
+{
+	TileEngine *tileEngine = _save->getTileEngine();
+	Pathfinding *pathfinding = _save->getPathfinding();
+	Log(LOG_INFO) << "Benchmark started with " << _units.size() << " units and " << _runs << " runs";
+
+	measure("TileEngine::calculateLineVoxel", [&]
+	{
+		int ops = 0;
+		for (auto* from : _units)
+		{
+			Position origin = tileEngine->getSightOriginVoxel(from);
+			for (auto* to : _units)
+			{
+				if (from != to)
+				{
+					tileEngine->calculateLineVoxel(origin, to->getPosition().toVoxel() + Position(8, 8, 12), false, nullptr, from);
+					++ops;
+				}
+			}
+		}
+		return ops;
+	});
+
+	measure("TileEngine::checkVoxelExposure", [&]
+	{
+		int ops = 0;
+		for (auto* from : _units)
+		{
+			Position origin = tileEngine->getSightOriginVoxel(from);
+			for (auto* to : _units)
+			{
+				if (from != to)
+				{
+					tileEngine->checkVoxelExposure(&origin, to->getTile(), from);
+					++ops;
+				}
+			}
+		}
+		return ops;
+	});
+
+	measure("TileEngine::calculateTilesInFOV", [&]
+	{
+		for (auto* unit : _units)
+		{
+			tileEngine->calculateTilesInFOV(unit);
+		}
+		return (int)_units.size();
+	});
+
+	measure("TileEngine::calculateLighting", [&]
+	{
+		tileEngine->calculateLighting(LL_AMBIENT, TileEngine::invalid, 0, true);
+		return 1;
+	});
+
+	measure("Pathfinding::calculate", [&]
+	{
+		int ops = 0;
+		for (auto* unit : _units)
+		{
+			for (auto& target : _targets)
+			{
+				if (target != unit->getPosition())
+				{
+					pathfinding->calculate(unit, target, BAM_NORMAL);
+					++ops;
+				}
+			}
+		}
+		pathfinding->abortPath();
+		return ops;
+	});
+
+	measure("Pathfinding::findReachablePathFindingNodes", [&]
+	{
+		for (auto* unit : _units)
+		{
+			bool ranOutOfTUs = false;
+			pathfinding->findReachablePathFindingNodes(unit, BattleActionCost(), ranOutOfTUs, true);
+		}
+		return (int)_units.size();
+	});
+
+	measure("AIModule::getCoverValue", [&]
+	{
+		int ops = 0;
+		for (auto* unit : _units)
+		{
+			AIModule ai(_save, unit, nullptr);
+			Position center = unit->getPosition();
+			for (int x = center.x - COVER_RADIUS; x <= center.x + COVER_RADIUS; ++x)
+			{
+				for (int y = center.y - COVER_RADIUS; y <= center.y + COVER_RADIUS; ++y)
+				{
+					Tile *tile = _save->getTile(Position(x, y, center.z));
+					if (tile)
+					{
+						ai.getCoverValue(tile, unit);
+						++ops;
+					}
+				}
+			}
+		}
+		return ops;
+	});
+
+	measure("Map::draw", [&]
+	{
+		for (auto* unit : _units)
+		{
+			_map->getCamera()->centerOnPosition(unit->getPosition(), false);
+			_map->invalidate();
+			_map->draw();
+		}
+		return (int)_units.size();
+	});
+
+	measure("ScriptWorkerBlit::executeBlit", [&]
+	{
+		int ops = 0;
+		Surface dest(64, 64);
+		dest.setPalette(_map->getPalette());
+		for (auto* unit : _units)
+		{
+			SurfaceSet *sprites = _game->getMod()->getSurfaceSet(unit->getArmor()->getSpriteSheet(), false);
+			const Surface *sprite = sprites ? sprites->getFrame(0) : nullptr;
+			if (!sprite)
+			{
+				continue;
+			}
+			ScriptWorkerBlit work;
+			BattleUnit::ScriptFill(&work, unit, _save, BODYPART_TORSO, 0, 0, 0);
+			dest.lock();
+			for (int i = 0; i < BLIT_REPEAT; ++i)
+			{
+				work.executeBlit(sprite, &dest, 0, 0, 0);
+				++ops;
+			}
+			dest.unlock();
+		}
+		return ops;
+	});
+
+	measure("ScriptWorkerBlit::executeBlit dispatch", [&]
+	{
+		// one pixel of every color, the per color results can't be reused and every pixel runs the scripts
+		Surface colors(16, 16);
+		colors.lock();
+		for (int i = 0; i < 256; ++i)
+		{
+			colors.setPixel(i % 16, i / 16, i);
+		}
+		colors.unlock();
+		Surface dest(16, 16);
+		dest.setPalette(_map->getPalette());
+		int ops = 0;
+		for (auto* unit : _units)
+		{
+			ScriptWorkerBlit work;
+			BattleUnit::ScriptFill(&work, unit, _save, BODYPART_TORSO, 0, 0, 0);
+			if (!work.hasScript())
+			{
+				continue;
+			}
+			dest.lock();
+			for (int i = 0; i < BLIT_REPEAT; ++i)
+			{
+				work.executeBlit(&colors, &dest, 0, 0, 0);
+				ops += 255;
+			}
+			dest.unlock();
+		}
+		return ops;
+	});
+
+	const RuleDamageType *damageType = _game->getMod()->getDamageType(DT_HE);
+	measureOnce("TileEngine::explode", [&]
+	{
+		for (auto& target : _targets)
+		{
+			tileEngine->explode({ }, target.toVoxel() + Position(8, 8, 12), 60, damageType, 6);
+		}
+		return (int)_targets.size();
+	});
+
+	std::string filename = Options::getUserFolder() + "benchmark_" + CrossPlatform::now() + ".json";
+	if (exportJson(filename))
+	{
+		Log(LOG_INFO) << "Benchmark results written to " << filename;
+	}
+	else
+	{
+		Log(LOG_ERROR) << "Failed to write benchmark results to " << filename;
+	}
+}
+
+}
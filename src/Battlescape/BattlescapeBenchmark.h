@@ -0,0 +1,67 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <functional>
+#include "Position.h"
+
+namespace OpenXcom
+{
+
+class Game;
+class SavedBattleGame;
+class Map;
+class BattleUnit;
+
+/**
+ * Times the battlescape engine kernels in isolation on a loaded battle.
+ * Started from the command line with -benchmark RUNS -load FILENAME,
+ * the results are logged and written as JSON to the user folder.
+ */
+class BattlescapeBenchmark
+{
+private:
+	struct Result
+	{
+		std::string name;
+		int ops;
+		std::vector<double> opsPerSecond;
+	};
+	Game *_game;
+	SavedBattleGame *_save;
+	Map *_map;
+	int _runs;
+	std::vector<BattleUnit*> _units;
+	std::vector<Position> _targets;
+	std::vector<Result> _results;
+	/// Times a kernel, which returns the number of operations it did.
+	void measure(const std::string &name, const std::function<int()> &kernel);
+	/// Times a kernel that changes the battle, in a single run.
+	void measureOnce(const std::string &name, const std::function<int()> &kernel);
+	/// Writes the results to a JSON file.
+	bool exportJson(const std::string &filename) const;
+public:
+	/// Creates a benchmark for the current battle.
+	BattlescapeBenchmark(Game *game, SavedBattleGame *save, Map *map, int runs);
+	/// Runs all kernels and reports the results.
+	void run();
+};
+
+}
@@ -56,6 +56,7 @@
 #include "InfoboxOKState.h"
 #include "UnitFallBState.h"
 #include "../Engine/Logger.h"
+#include "../Engine/Profiler.h"
 #include "../Savegame/BattleUnitStatistics.h"
 #include "ConfirmEndMissionState.h"
 #include "../fmath.h"
@@ -215,6 +216,7 @@ BattlescapeGame::~BattlescapeGame()
  */
 int BattlescapeGame::think()
 {
+	ProfileScope profile("BattlescapeGame::think");
 	int ret = -1;
 	// nothing is happening - see if we need some alien AI or units panicking or what have you
 	if (_states.empty())
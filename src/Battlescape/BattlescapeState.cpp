@@ -32,6 +32,7 @@
 #include "InventoryState.h"
 #include "AlienInventoryState.h"
 #include "Pathfinding.h"
+#include "BattlescapeBenchmark.h"
 #include "BattlescapeGame.h"
 #include "WarningMessage.h"
 #include "InfoboxState.h"
@@ -838,6 +839,17 @@ void BattlescapeState::init()
 		_btnReserveSnap->setGroup(&_reserve);
 		_btnReserveAimed->setGroup(&_reserve);
 		_btnReserveAuto->setGroup(&_reserve);
+
+		// the battle is on screen, whatever was not used by now was prefetched for nothing
+		_game->getMod()->clearPrefetchedSurfaces();
+
+		if (Options::getBenchmarkRuns() > 0)
+		{
+			BattlescapeBenchmark benchmark(_game, _save, _map, Options::getBenchmarkRuns());
+			benchmark.run();
+			_game->quit();
+			return;
+		}
 	}
 	_txtTooltip->setText("");
 	_btnReserveKneel->toggle(_save->getKneelReserved());
@@ -2208,34 +2220,7 @@ void BattlescapeState::updateSoldierInfo(bool checkFOV)
 				{
 					look = _game->getMod()->getArmor(soldier->getRules()->getArmorForAvatar())->getSpriteInventory();
 				}
-				const std::string gender = soldier->getGender() == GENDER_MALE ? "M" : "F";
-				std::stringstream ss;
-				Surface *surf = 0;
-
-				for (int i = 0; i <= RuleSoldier::LookVariantBits; ++i)
-				{
-					ss.str("");
-					ss << look;
-					ss << gender;
-					ss << (int)soldier->getLook() + (soldier->getLookVariant() & (RuleSoldier::LookVariantMask >> i)) * 4;
-					ss << ".SPK";
-					surf = _game->getMod()->getSurface(ss.str(), false);
-					if (surf)
-					{
-						break;
-					}
-				}
-				if (!surf)
-				{
-					ss.str("");
-					ss << look;
-					ss << ".SPK";
-					surf = _game->getMod()->getSurface(ss.str(), false);
-				}
-				if (!surf)
-				{
-					surf = _game->getMod()->getSurface(look, true);
-				}
+				Surface *surf = _game->getMod()->getFirstSurface(soldier->getSpriteInventoryNames(look));
 
 				// crop
 				auto crop = surf->getCrop();
@@ -34,6 +34,9 @@
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/Ufo.h"
 #include "../Mod/AlienDeployment.h"
+#include "../Mod/Armor.h"
+#include "../Savegame/BattleUnit.h"
+#include "../Savegame/Soldier.h"
 #include "../Mod/RuleUfo.h"
 #include "../Engine/Options.h"
 #include "../Engine/RNG.h"
@@ -218,6 +221,29 @@ BriefingState::BriefingState(Craft *craft, Base *base, bool infoOnly, BriefingDa
 
 	if (_infoOnly) return;
 
+	// decode the battle sprites while the player reads the briefing, units first
+	Mod *mod = _game->getMod();
+	for (const auto* unit : *battleSave->getUnits())
+	{
+		mod->prefetchSurfaces({ unit->getArmor()->getSpriteSheet() }, 1);
+
+		// only the paperdoll the inventory will show, looked up in the same order
+		const Soldier *s = unit->getGeoscapeSoldier();
+		if (s && s->getArmor()->hasLayersDefinition())
+		{
+			mod->prefetchSurfaces(s->getArmorLayers(), 1);
+		}
+		else if (s)
+		{
+			mod->prefetchFirstSurface(s->getSpriteInventoryNames(s->getArmor()->getSpriteInventory()), 1);
+		}
+		else
+		{
+			mod->prefetchFirstSurface(unit->getArmor()->getSpriteInventoryNames(), 1);
+		}
+	}
+	mod->prefetchSurfaces({ "SPICONS.DAT", "SCANG.DAT", "SMOKE.PCK", "HIT.PCK", "X1.PCK", "CURSOR.PCK", "TinyRanks", "KneelButton", "Touch" }, 0);
+
 	if (!isPreview && base && mission == "STR_BASE_DEFENSE")
 	{
 		auto* am = base->getRetaliationMission();
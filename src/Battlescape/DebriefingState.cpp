@@ -66,6 +66,7 @@
 #include "../Interface/Cursor.h"
 #include "../Engine/Exception.h"
 #include "../Engine/Options.h"
+#include "../Engine/Script.h"
 #include "../Engine/RNG.h"
 #include "../Basescape/ManageAlienContainmentState.h"
 #include "../Basescape/TransferBaseState.h"
@@ -802,6 +803,11 @@ void DebriefingState::init()
 
 	_game->getSavedGame()->setBattleGame(0);
 
+	if (Options::oxceScriptProfiler)
+	{
+		_game->getMod()->getScriptGlobal()->logProfile();
+	}
+
 	if (_positiveScore)
 	{
 		_game->getMod()->playMusic(Mod::DEBRIEF_MUSIC_GOOD);
@@ -36,6 +36,7 @@
 #include "../Engine/Screen.h"
 #include "../Engine/ShaderDraw.h"
 #include "../Engine/ShaderMove.h"
+#include "../Engine/Profiler.h"
 #include "../Savegame/SavedBattleGame.h"
 #include "../Savegame/Tile.h"
 #include "../Savegame/BattleUnit.h"
@@ -221,6 +222,7 @@ Map::Map(Game *game, int width, int height, int x, int y, int visibleMapHeight)
 
 	_vaporParticlesInit.resize(_camera->getMapSizeY() * _camera->getMapSizeX());
 	_vaporParticles.resize(_camera->getMapSizeY() * _camera->getMapSizeX());
+	_nightVisionCoverage.resize(_camera->getMapSizeY() * _camera->getMapSizeX());
 }
 
 /**
@@ -718,9 +720,12 @@ void Map::drawUnit(UnitSprite &unitSprite, Tile *unitTile, Tile *currTile, Posit
  */
 void Map::drawTerrain(Surface *surface)
 {
+	ProfileScope profile("Map::drawTerrain");
 	if (Options::oxceFOW)
 		_save->updateVisibleTiles();
 
+	updateNightVisionCoverage();
+
 	_isAltPressed = _game->isAltPressed(true);
 	_isCtrlPressed = _game->isCtrlPressed(true);
 	int frameNumber = 0;
@@ -887,13 +892,37 @@ void Map::drawTerrain(Surface *surface)
 		bool topLayer = itZ == endZ;
 		for (int itY = beginY; itY < endY; itY++)
 		{
-			mapPosition = Position(beginX, itY, itZ);
+			// along a row both screen coordinates grow with x, so skip straight to the first tile inside the surface
+			int rowBeginX = beginX;
+			_camera->convertMapToScreen(Position(beginX, itY, itZ), &screenPosition);
+			screenPosition += cameraPos;
+			if (screenPosition.x <= -_spriteWidth)
+			{
+				rowBeginX = std::max(rowBeginX, beginX + (-_spriteWidth - screenPosition.x) / (_spriteWidth / 2) + 1);
+			}
+			if (screenPosition.y <= -_spriteHeight)
+			{
+				rowBeginX = std::max(rowBeginX, beginX + (-_spriteHeight - screenPosition.y) / (_spriteWidth / 4) + 1);
+			}
+			if (rowBeginX >= endX)
+			{
+				continue;
+			}
+
+			mapPosition = Position(rowBeginX, itY, itZ);
 			tile = _save->getTile(mapPosition);
-			for (int itX = beginX; itX < endX; itX++, mapPosition.x++, tile++)
+			for (int itX = rowBeginX; itX < endX; itX++, mapPosition.x++, tile++)
 			{
 				_camera->convertMapToScreen(mapPosition, &screenPosition);
 				screenPosition += cameraPos;
 
+				// and stop at the first one past its right or bottom edge
+				if (screenPosition.x >= surface->getWidth() + _spriteWidth ||
+					screenPosition.y >= surface->getHeight() + _spriteHeight)
+				{
+					break;
+				}
+
 				// only render cells that are inside the surface
 				if (screenPosition.x > -_spriteWidth && screenPosition.x < surface->getWidth() + _spriteWidth &&
 					screenPosition.y > -_spriteHeight && screenPosition.y < surface->getHeight() + _spriteHeight )
@@ -2273,19 +2302,74 @@ int Map::reShade(Tile *tile)
 	}
 
 	// hybrid night vision (local)
+	const Position pos = tile->getPosition();
+	if (_nightVisionCoverage[pos.y * _save->getMapSizeX() + pos.x])
+	{
+		return tile->getShade() > _fadeShade ? _fadeShade : tile->getShade();
+	}
+
+	// hybrid night vision (global)
+	return std::min(+NIGHT_VISION_MAX_SHADE, tile->getShade());
+}
+
+/**
+ * Rebuilds the map of columns lit by the local night vision of player units.
+ * Every tile in the viewport asks for it in reShade() each frame, so it is only
+ * recalculated when some player unit moved, fell or changed its view range.
+ */
+void Map::updateNightVisionCoverage()
+{
+	_nightVisionCoverageNextKey.clear();
 	for (const auto* bu : *_save->getUnits())
 	{
 		if (bu->getFaction() == FACTION_PLAYER && !bu->isOut())
 		{
-			if (Position::distance2dSq(tile->getPosition(), bu->getPosition()) <= bu->getMaxViewDistanceAtDarkSquared())
+			const Position pos = bu->getPosition();
+			_nightVisionCoverageNextKey.push_back(pos.x);
+			_nightVisionCoverageNextKey.push_back(pos.y);
+			_nightVisionCoverageNextKey.push_back(bu->getMaxViewDistanceAtDarkSquared());
+		}
+	}
+
+	if (_nightVisionCoverageNextKey == _nightVisionCoverageKey)
+	{
+		return;
+	}
+	_nightVisionCoverageKey.swap(_nightVisionCoverageNextKey);
+
+	std::fill(_nightVisionCoverage.begin(), _nightVisionCoverage.end(), 0);
+
+	const int sizeX = _save->getMapSizeX();
+	const int sizeY = _save->getMapSizeY();
+	for (size_t i = 0; i + 2 < _nightVisionCoverageKey.size(); i += 3)
+	{
+		const int unitX = _nightVisionCoverageKey[i];
+		const int unitY = _nightVisionCoverageKey[i + 1];
+		const int rangeSq = _nightVisionCoverageKey[i + 2];
+		if (rangeSq < 0)
+		{
+			continue;
+		}
+
+		int range = (int)std::sqrt((double)rangeSq);
+		while ((range + 1) * (range + 1) <= rangeSq)
+		{
+			++range;
+		}
+
+		const int endY = std::min(sizeY - 1, unitY + range);
+		const int endX = std::min(sizeX - 1, unitX + range);
+		for (int y = std::max(0, unitY - range); y <= endY; ++y)
+		{
+			for (int x = std::max(0, unitX - range); x <= endX; ++x)
 			{
-				return tile->getShade() > _fadeShade ? _fadeShade : tile->getShade();
+				if (Position::distance2dSq(Position(x, y, 0), Position(unitX, unitY, 0)) <= rangeSq)
+				{
+					_nightVisionCoverage[y * sizeX + x] = 1;
+				}
 			}
 		}
 	}
-
-	// hybrid night vision (global)
-	return std::min(+NIGHT_VISION_MAX_SHADE, tile->getShade());
 }
 
 /**
@@ -26,6 +26,7 @@
 #include "../Mod/Mod.h"
 #include "../Savegame/BattleUnit.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "../fmath.h"
 #include "BattlescapeGame.h"
 
@@ -103,6 +104,7 @@ void Pathfinding::calculate(BattleUnit *unit, Position endPosition, BattleAction
  */
 void Pathfinding::calculate(BattleUnit *unit, Position startPosition, Position endPosition, BattleActionMove bam, const BattleUnit *missileTarget, int maxTUCost)
 {
+	ProfileScope profile("Pathfinding::calculate");
 	_totalTUCost = {};
 	_path.clear();
 
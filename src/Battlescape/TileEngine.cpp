@@ -39,6 +39,7 @@
 #include "../Mod/Armor.h"
 #include "../Mod/RuleSkill.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "ProjectileFlyBState.h"
 #include "MeleeAttackBState.h"
 #include "../fmath.h"
@@ -1095,6 +1096,7 @@ void TileEngine::calculateUnitLighting(MapSubset gs)
 
 void TileEngine::calculateLighting(LightLayers layer, Position position, int eventRadius, bool terrianChanged)
 {
+	ProfileScope profile("TileEngine::calculateLighting");
 	auto gsDynamic = MapSubset{ _save->getMapSizeX(), _save->getMapSizeY() };
 	auto gsStatic = gsDynamic;
 
@@ -1637,6 +1639,7 @@ void TileEngine::calculateTilesInFOV(BattleUnit* unit, const Position eventPos,
 */
 bool TileEngine::calculateFOV(BattleUnit *unit, bool doTileRecalc, bool doUnitRecalc)
 {
+	ProfileScope profile("TileEngine::calculateFOV");
 	//Force a full FOV recheck for this unit.
 	if (doTileRecalc) calculateTilesInFOV(unit);
 	return doUnitRecalc ? calculateUnitsInFOV(unit) : false;
@@ -2774,6 +2777,7 @@ Position TileEngine::adjustTargetVoxelFromTileType(Position *originVoxel, Tile *
  */
 void TileEngine::calculateFOV(Position position, int eventRadius, const bool updateTiles, const bool appendToTileVisibility)
 {
+	ProfileScope profile("TileEngine::calculateFOV");
 	int updateRadius;
 	if (eventRadius == -1)
 	{
@@ -3656,6 +3660,7 @@ void TileEngine::hit(BattleActionAttack attack, Position center, int power, cons
  */
 void TileEngine::explode(BattleActionAttack attack, Position center, int power, const RuleDamageType *type, int maxRadius, bool rangeAtack)
 {
+	ProfileScope profile("TileEngine::explode");
 	const Position centetTile = center.toTile();
 	int hitSide = 0;
 	int diagonalWall = 0;
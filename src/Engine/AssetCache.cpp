@@ -0,0 +1,387 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "AssetCache.h"
+#include <algorithm>
+#include <cstring>
+#include <tuple>
+#include "Surface.h"
+#include "FileMap.h"
+#include "Logger.h"
+#include "Exception.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/// Identifies the file format, changes when the layout of any entry changes.
+const char CacheMagic[8] = { 'O', 'X', 'C', 'A', 'C', 'H', 'E', '1' };
+
+/// Blobs are aligned so tables can be used straight from the file buffer.
+const size_t CacheAlign = 16;
+
+struct CacheHeader
+{
+	char magic[8];
+	Uint64 count;
+};
+
+struct CacheEntry
+{
+	Uint64 key;
+	Uint64 offset;
+	Uint64 size;
+};
+
+struct SurfaceHeader
+{
+	Uint32 width;
+	Uint32 height;
+	Uint32 colors;
+	Uint32 unused;
+};
+
+size_t alignUp(size_t size)
+{
+	return (size + CacheAlign - 1) / CacheAlign * CacheAlign;
+}
+
+}
+
+/**
+ * Hashes a block of memory with FNV-1a.
+ * @param data Memory to hash.
+ * @param size Size of the memory.
+ * @param seed Hash of previous data, to chain calls.
+ * @return The hash.
+ */
+Uint64 AssetCache::hash(const void *data, size_t size, Uint64 seed)
+{
+	const Uint8 *bytes = (const Uint8*)data;
+	Uint64 h = seed;
+	for (size_t i = 0; i < size; ++i)
+	{
+		h ^= bytes[i];
+		h *= 1099511628211ULL;
+	}
+	return h;
+}
+
+/**
+ * Opens the cache file. A missing or broken file just means an empty cache.
+ * @param filename Full path of the cache file.
+ */
+AssetCache::AssetCache(const std::string &filename) : _filename(filename), _dirty(false)
+{
+	if (!CrossPlatform::fileExists(_filename))
+	{
+		return;
+	}
+	_file = CrossPlatform::mapFileRaw(_filename);
+	if (!_file)
+	{
+		// platforms without mapping
+		try
+		{
+			auto data = std::make_shared<RawData>(CrossPlatform::readFileRaw(_filename));
+			_file = RawSpan(data, data->data(), data->size());
+		}
+		catch (Exception &)
+		{
+			return;
+		}
+	}
+
+	const Uint8 *begin = (const Uint8*)_file.data();
+	size_t size = _file.size();
+	CacheHeader header;
+	if (size < sizeof(header))
+	{
+		return;
+	}
+	memcpy(&header, begin, sizeof(header));
+	if (memcmp(header.magic, CacheMagic, sizeof(CacheMagic)) != 0 || header.count > (size - sizeof(header)) / sizeof(CacheEntry))
+	{
+		Log(LOG_WARNING) << "Ignoring invalid asset cache: " << _filename;
+		return;
+	}
+	for (Uint64 i = 0; i < header.count; ++i)
+	{
+		CacheEntry entry;
+		memcpy(&entry, begin + sizeof(header) + i * sizeof(entry), sizeof(entry));
+		if (entry.offset > size || entry.size > size - entry.offset)
+		{
+			Log(LOG_WARNING) << "Ignoring invalid asset cache: " << _filename;
+			_blobs.clear();
+			return;
+		}
+		_blobs[entry.key] = Blob{ begin + entry.offset, (size_t)entry.size, false };
+	}
+	Log(LOG_INFO) << "Asset cache: " << _blobs.size() << " entries in " << _filename;
+}
+
+/**
+ * Writes any new entries before closing.
+ */
+AssetCache::~AssetCache()
+{
+	save();
+}
+
+/**
+ * Gets the key of a file from the virtual file system, covering its name
+ * and contents, without reading it.
+ * @param filename Virtual filename.
+ * @return The key.
+ */
+Uint64 AssetCache::getFileKey(const std::string &filename)
+{
+	Uint64 stamp = FileMap::at(filename)->getStamp();
+	return hash(&stamp, sizeof(stamp), hash(FileMap::canonicalize(filename)));
+}
+
+/**
+ * Gets the key of a file record, covering its full path and contents.
+ * Zip entries come with a checksum of their contents,
+ * loose files are hashed, which is still much faster than parsing them.
+ * @param record File record.
+ * @return The key.
+ */
+Uint64 AssetCache::getFileKey(const FileMap::FileRecord &record)
+{
+	Uint64 stamp = record.getStamp();
+	Uint64 key = hash(&stamp, sizeof(stamp), hash(record.fullpath));
+	if (record.zip == NULL)
+	{
+		RawSpan file = CrossPlatform::mapFileRaw(record.fullpath);
+		if (file)
+		{
+			key = hash(file.data(), file.size(), key);
+		}
+	}
+	return key;
+}
+
+/**
+ * Gets the data of an entry.
+ * @param key Key of the entry.
+ * @param size Expected size of the data.
+ * @return Pointer to the data, or null if there's no entry of that size.
+ */
+const Uint8 *AssetCache::find(Uint64 key, size_t size) const
+{
+	auto i = _blobs.find(key);
+	if (i == _blobs.end() || i->second.size != size)
+	{
+		return nullptr;
+	}
+	i->second.used = true;
+	return i->second.data;
+}
+
+/**
+ * Gets the data of an entry, whatever its size.
+ * @param key Key of the entry.
+ * @param size Set to the size of the data.
+ * @return Pointer to the data, or null if there's no entry.
+ */
+const Uint8 *AssetCache::findAny(Uint64 key, size_t &size) const
+{
+	auto i = _blobs.find(key);
+	if (i == _blobs.end())
+	{
+		return nullptr;
+	}
+	i->second.used = true;
+	size = i->second.size;
+	return i->second.data;
+}
+
+/**
+ * Adds an entry, replacing the old one with the same key.
+ * @param key Key of the entry.
+ * @param data Data to copy.
+ * @param size Size of the data.
+ */
+void AssetCache::store(Uint64 key, const void *data, size_t size)
+{
+	_added.emplace_back((const Uint8*)data, (const Uint8*)data + size);
+	_blobs[key] = Blob{ _added.back().data(), size, true };
+	_dirty = true;
+}
+
+/**
+ * Replaces a surface with the image stored in an entry.
+ * @param key Key of the entry.
+ * @param surface Surface to replace.
+ * @return True if there was an entry.
+ */
+bool AssetCache::loadSurface(Uint64 key, Surface *surface) const
+{
+	auto i = _blobs.find(key);
+	if (i == _blobs.end() || i->second.size < sizeof(SurfaceHeader))
+	{
+		return false;
+	}
+	SurfaceHeader header;
+	memcpy(&header, i->second.data, sizeof(header));
+	if (header.colors > 256 || i->second.size != sizeof(header) + header.colors * sizeof(SDL_Color) + (size_t)header.width * header.height)
+	{
+		return false;
+	}
+	i->second.used = true;
+	const Uint8 *colors = i->second.data + sizeof(header);
+	const Uint8 *pixels = colors + header.colors * sizeof(SDL_Color);
+
+	*surface = Surface(header.width, header.height, 0, 0);
+	surface->setPalette((SDL_Color*)colors, 0, header.colors);
+	for (Uint32 y = 0; y < header.height; ++y)
+	{
+		memcpy(surface->getRaw(0, y), pixels + y * header.width, header.width);
+	}
+	return true;
+}
+
+/**
+ * Adds an entry with the pixels and palette of a surface.
+ * @param key Key of the entry.
+ * @param surface 8bpp surface to store, empty ones are skipped.
+ */
+void AssetCache::storeSurface(Uint64 key, Surface *surface)
+{
+	if (!*surface)
+	{
+		return;
+	}
+	SDL_Palette *palette = surface->getSurface()->format->palette;
+	SurfaceHeader header = { (Uint32)surface->getWidth(), (Uint32)surface->getHeight(), palette ? (Uint32)palette->ncolors : 0u, 0u };
+
+	std::vector<Uint8> data(sizeof(header) + header.colors * sizeof(SDL_Color) + (size_t)header.width * header.height);
+	memcpy(data.data(), &header, sizeof(header));
+	if (header.colors)
+	{
+		memcpy(data.data() + sizeof(header), palette->colors, header.colors * sizeof(SDL_Color));
+	}
+	Uint8 *pixels = data.data() + sizeof(header) + header.colors * sizeof(SDL_Color);
+	for (Uint32 y = 0; y < header.height; ++y)
+	{
+		memcpy(pixels + y * header.width, surface->getRaw(0, y), header.width);
+	}
+	store(key, data.data(), data.size());
+}
+
+/**
+ * Writes the cache file, if anything was added since it was loaded.
+ * Only entries used by this session are kept, so data of edited files
+ * doesn't pile up. The cache is empty afterwards, as the file it was
+ * mapped from gets replaced.
+ */
+void AssetCache::save()
+{
+	if (!_dirty)
+	{
+		return;
+	}
+	_dirty = false;
+
+	size_t count = 0;
+	for (const auto& pair : _blobs)
+	{
+		if (pair.second.used)
+		{
+			++count;
+		}
+	}
+
+	CacheHeader header;
+	memcpy(header.magic, CacheMagic, sizeof(CacheMagic));
+	header.count = count;
+
+	size_t offset = alignUp(sizeof(header) + count * sizeof(CacheEntry));
+	std::vector<CacheEntry> entries;
+	entries.reserve(count);
+	for (const auto& pair : _blobs)
+	{
+		if (pair.second.used)
+		{
+			entries.push_back(CacheEntry{ pair.first, offset, pair.second.size });
+			offset = alignUp(offset + pair.second.size);
+		}
+	}
+
+	std::vector<unsigned char> data(offset);
+	memcpy(data.data(), &header, sizeof(header));
+	memcpy(data.data() + sizeof(header), entries.data(), entries.size() * sizeof(CacheEntry));
+	for (const auto& entry : entries)
+	{
+		const Blob &blob = _blobs[entry.key];
+		memcpy(data.data() + entry.offset, blob.data, blob.size);
+	}
+
+	// the old file can't be overwritten while it's still mapped
+	_blobs.clear();
+	_added.clear();
+	_file = RawSpan();
+	if (CrossPlatform::writeFile(_filename, data))
+	{
+		Log(LOG_INFO) << "Asset cache: saved " << entries.size() << " entries, " << data.size() / 1024 << " KB.";
+	}
+}
+
+/**
+ * Deletes the least recently written cache files of other mod lists,
+ * which get files of their own, once all the files take too much space.
+ * @param folder Cache folder.
+ * @param suffix End of the file names of the current mod list, always kept.
+ */
+void AssetCache::prune(const std::string &folder, const std::string &suffix)
+{
+	std::vector<std::pair<time_t, std::string>> others;
+	Uint64 total = 0;
+	for (const auto& entry : CrossPlatform::getFolderContents(folder, "dat"))
+	{
+		const std::string &name = std::get<0>(entry);
+		if (std::get<1>(entry))
+		{
+			continue;
+		}
+		total += CrossPlatform::getFileSize(folder + name);
+		if (name.size() < suffix.size() || name.compare(name.size() - suffix.size(), suffix.size(), suffix) != 0)
+		{
+			others.push_back(std::make_pair(std::get<2>(entry), name));
+		}
+	}
+	std::sort(others.begin(), others.end());
+	for (const auto& other : others)
+	{
+		if (total <= FolderLimit)
+		{
+			break;
+		}
+		Uint64 size = CrossPlatform::getFileSize(folder + other.second);
+		if (CrossPlatform::deleteFile(folder + other.second))
+		{
+			total -= size;
+			Log(LOG_INFO) << "Asset cache: removed " << other.second;
+		}
+	}
+}
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <SDL.h>
+#include "CrossPlatform.h"
+
+namespace OpenXcom
+{
+
+class Surface;
+namespace FileMap { struct FileRecord; }
+
+/**
+ * On-disk cache of data that is expensive to compute at startup,
+ * like decoded images and palette lookup tables.
+ * Entries are blobs identified by a 64-bit key that must cover everything
+ * the data was made from, so stale entries are simply never found again.
+ * The file is a flat index followed by aligned blobs, mapped into memory
+ * and used in place. It is only rewritten when something new was stored,
+ * and then keeps just the entries used by this session.
+ */
+class AssetCache
+{
+private:
+	struct Blob
+	{
+		const Uint8 *data;
+		size_t size;
+		mutable bool used;
+	};
+
+	std::string _filename;
+	RawSpan _file;
+	std::unordered_map<Uint64, Blob> _blobs;
+	std::vector<std::vector<Uint8>> _added;
+	bool _dirty;
+public:
+	/// Starts a new hash.
+	static constexpr Uint64 HashSeed = 14695981039346656037ULL;
+	/// Space the cache folder may take, including other mod lists.
+	static constexpr Uint64 FolderLimit = 512ULL << 20;
+	/// Hashes a block of memory, FNV-1a.
+	static Uint64 hash(const void *data, size_t size, Uint64 seed = HashSeed);
+	/// Hashes a string.
+	static Uint64 hash(const std::string &str, Uint64 seed = HashSeed) { return hash(str.data(), str.size(), seed); }
+
+	/// Opens the cache file, if there is a valid one.
+	AssetCache(const std::string &filename);
+	/// Cleans up the cache.
+	~AssetCache();
+	/// Gets the key of an image file from the virtual file system.
+	static Uint64 getFileKey(const std::string &filename);
+	/// Gets the key of a file record, like a ruleset of a mod.
+	static Uint64 getFileKey(const FileMap::FileRecord &record);
+	/// Checks if there is an entry.
+	bool contains(Uint64 key) const { return _blobs.find(key) != _blobs.end(); }
+	/// Gets an entry.
+	const Uint8 *find(Uint64 key, size_t size) const;
+	/// Gets an entry of any size.
+	const Uint8 *findAny(Uint64 key, size_t &size) const;
+	/// Adds an entry.
+	void store(Uint64 key, const void *data, size_t size);
+	/// Loads a surface from an entry.
+	bool loadSurface(Uint64 key, Surface *surface) const;
+	/// Adds an entry with a surface.
+	void storeSurface(Uint64 key, Surface *surface);
+	/// Writes the cache file if anything was added, and empties the cache.
+	void save();
+	/// Deletes the oldest cache files of other mod lists if the folder is too big.
+	static void prune(const std::string &folder, const std::string &suffix);
+};
+
+}
@@ -26,11 +26,15 @@
 #include <fstream>
 #include <string>
 #include <list>
+#include <atomic>
 #include <stdint.h>
+#include <stdlib.h>
 #include <time.h>
 #include <signal.h>
 #include <sys/stat.h>
 #include <assert.h>
+#include <SDL_mutex.h>
+#include <SDL_thread.h>
 #include "Logger.h"
 #include "Exception.h"
 #include "Options.h"
@@ -46,6 +50,7 @@
 #include <shellapi.h>
 #include <wininet.h>
 #include <urlmon.h>
+#include <psapi.h>
 #ifndef __NO_DBGHELP
 #include <dbghelp.h>
 #endif
@@ -59,6 +64,7 @@
 #pragma comment(lib, "shlwapi.lib")
 #pragma comment(lib, "wininet.lib")
 #pragma comment(lib, "urlmon.lib")
+#pragma comment(lib, "psapi.lib")
 #ifndef __NO_DBGHELP
 #pragma comment(lib, "dbghelp.lib")
 #endif
@@ -74,6 +80,9 @@
 #include <unistd.h>
 #include <sys/param.h>
 #include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <fcntl.h>
 #include <pwd.h>
 #ifndef __CYGWIN__
 #include <execinfo.h>
@@ -961,6 +970,39 @@ time_t getDateModified(const std::string &path)
 #endif
 }
 
+/**
+ * Gets the size of a file.
+ * @param path Full path to file.
+ * @return The size in bytes, 0 if the file can't be accessed.
+ */
+Uint64 getFileSize(const std::string &path)
+{
+#ifdef _WIN32
+	Uint64 rv = 0;
+	auto pathW = pathToWindows(path);
+	auto fh = CreateFileW(pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, 0, NULL);
+	if (fh == INVALID_HANDLE_VALUE) {
+		return 0;
+	}
+	LARGE_INTEGER size;
+	if (GetFileSizeEx(fh, &size)) {
+		rv = size.QuadPart;
+	}
+	CloseHandle(fh);
+	return rv;
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) == 0)
+	{
+		return info.st_size;
+	}
+	else
+	{
+		return 0;
+	}
+#endif
+}
+
 /**
  * Converts a date/time into a human-readable string
  * using the ISO 8601 standard.
@@ -1126,6 +1168,65 @@ RawData readFileRaw(const std::string& filename)
 	return RawData(data, s, SDL_free);
 }
 
+/**
+ * Maps a file read-only to memory, without copying it.
+ * @param filename - what to map
+ * @return the mapped file, empty if it can't be mapped and needs to be read instead.
+ */
+RawSpan mapFileRaw(const std::string& filename)
+{
+#ifdef _WIN32
+	auto pathW = pathToWindows(filename);
+	HANDLE fh = CreateFileW(pathW.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (fh == INVALID_HANDLE_VALUE)
+	{
+		return RawSpan();
+	}
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(fh, &size) || size.QuadPart <= 0 || (Uint64)size.QuadPart > SIZE_MAX)
+	{
+		CloseHandle(fh);
+		return RawSpan();
+	}
+	HANDLE mh = CreateFileMappingW(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(fh);
+	if (mh == NULL)
+	{
+		return RawSpan();
+	}
+	// the view keeps the mapping alive
+	void *view = MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mh);
+	if (view == NULL)
+	{
+		return RawSpan();
+	}
+	return RawSpan(std::shared_ptr<const void>(view, [](const void *p) { UnmapViewOfFile(p); }), view, (size_t)size.QuadPart);
+#elif defined(__MORPHOS__)
+	return RawSpan();
+#else
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return RawSpan();
+	}
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size <= 0)
+	{
+		::close(fd);
+		return RawSpan();
+	}
+	size_t size = info.st_size;
+	void *view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (view == MAP_FAILED)
+	{
+		return RawSpan();
+	}
+	return RawSpan(std::shared_ptr<const void>(view, [size](const void *p) { munmap(const_cast<void*>(p), size); }), view, size);
+#endif
+}
+
 /**
  * Gets an istream to a file's bytes at least up to and including first "\n---" sequence.
  * To be used only for savegames.
@@ -1484,6 +1585,35 @@ std::string now()
 	return result;
 }
 
+/**
+ * Gets the largest amount of memory the process had resident so far.
+ * @return Peak resident set size in bytes, 0 if unknown.
+ */
+size_t getPeakMemory()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.PeakWorkingSetSize;
+	}
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+	{
+		return 0;
+	}
+#ifdef __APPLE__
+	return usage.ru_maxrss;
+#else
+	return (size_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+static void flushLogOnCrash();
+
 /**
  * Logs the details of this crash and shows an error.
  * @param ex Pointer to exception data (PEXCEPTION_POINTERS on Windows, signal int on Unix)
@@ -1558,6 +1688,7 @@ void crashDump(void *ex, const std::string &err)
 	msg << "2. a detailed description how to reproduce the crash (helps 80%)" << std::endl;
 	msg << "3. a log file (helps 10%)" << std::endl;
 	msg << "4. a screenshot of this error message (helps 5%)";
+	flushLogOnCrash();
 	showError(msg.str());
 }
 
@@ -1600,10 +1731,198 @@ static bool logToFile(const std::string& filename, const std::string& data) {
 }
 
 static const size_t LOG_BUFFER_LIMIT = 1<<10;
+static const size_t LOG_PENDING_RESERVE = 1<<16;
+static const size_t LOG_PENDING_LIMIT = 1<<22;
 static std::list<std::pair<int, std::string>> logBuffer;
 static std::string logFileName;
+static std::string logPending;
+static SDL_Thread *logWriter = 0;
+static SDL_cond *logWake = 0;
+static bool logWriterQuit = false;
 const std::string& getLogFileName() { return logFileName; }
 
+static std::atomic<Uint32> logLockOwner(0);
+static int logLockDepth = 0;
+
+/**
+ * Guards all log state, messages can come from background loaders too.
+ */
+static SDL_mutex *getLogMutex()
+{
+	static SDL_mutex *logMutex = SDL_CreateMutex();
+	return logMutex;
+}
+
+/**
+ * Takes the log lock, remembering which thread holds it.
+ */
+static void lockLog()
+{
+	SDL_mutexP(getLogMutex());
+	if (logLockDepth++ == 0)
+	{
+		logLockOwner = SDL_ThreadID();
+	}
+}
+
+/**
+ * Releases the log lock.
+ */
+static void unlockLog()
+{
+	if (--logLockDepth == 0)
+	{
+		logLockOwner = 0;
+	}
+	SDL_mutexV(getLogMutex());
+}
+
+/**
+ * Takes the log lock unless another thread holds it,
+ * that thread could be stuck in a crash and never let go.
+ * @return If the lock was taken.
+ */
+static bool tryLockLog()
+{
+	Uint32 owner = logLockOwner;
+	if (owner != 0 && owner != SDL_ThreadID())
+	{
+		return false;
+	}
+	lockLog();
+	return true;
+}
+
+/**
+ * Waits for the writer to be woken up, releasing the log lock meanwhile.
+ * @param timeout Milliseconds to wait at most, 0 to wait forever.
+ */
+static void waitLog(Uint32 timeout)
+{
+	int depth = logLockDepth;
+	logLockDepth = 0;
+	logLockOwner = 0;
+	if (timeout)
+	{
+		SDL_CondWaitTimeout(logWake, getLogMutex(), timeout);
+	}
+	else
+	{
+		SDL_CondWait(logWake, getLogMutex());
+	}
+	logLockDepth = depth;
+	logLockOwner = SDL_ThreadID();
+}
+
+/**
+ * Keeps text that could not be written, so it is retried with the next batch.
+ * Text is dropped when the backlog grows too big.
+ * @param data Text that failed to write, older than anything pending.
+ */
+static void logRetain(const std::string& data)
+{
+	if (data.size() + logPending.size() < LOG_PENDING_LIMIT)
+	{
+		logPending.insert(0, data);
+	}
+	std::string err = "Failed to append to '" + logFileName + "': " + SDL_GetError() + "\n";
+	fwrite(err.c_str(), err.size(), 1, stderr);
+}
+
+/**
+ * Background thread writing queued log text to the log file.
+ * Everything queued while a write is in progress goes out in the next batch,
+ * so the file is opened once per batch instead of once per line.
+ */
+static int logWriterThread(void *)
+{
+	std::string batch;
+	batch.reserve(LOG_PENDING_RESERVE);
+	lockLog();
+	while (true)
+	{
+		while (logPending.empty() && !logWriterQuit)
+		{
+			waitLog(0);
+		}
+		if (logPending.empty())
+		{
+			break;
+		}
+		batch.swap(logPending);
+		std::string fileName = logFileName;
+		unlockLog();
+		bool written = logToFile(fileName, batch);
+		lockLog();
+		if (!written && !logWriterQuit)
+		{
+			logRetain(batch);
+			// give the file system some time before the next attempt
+			waitLog(1000);
+		}
+		else if (!written)
+		{
+			// last pass, these are the lines right before a quit or crash, don't lose them
+			unlockLog();
+			if (!logToFile(fileName, batch))
+			{
+				std::string err = "Failed to append to '" + fileName + "': " + SDL_GetError() + "\n";
+				fwrite(err.c_str(), err.size(), 1, stderr);
+				fwrite(batch.c_str(), batch.size(), 1, stderr);
+			}
+			lockLog();
+		}
+		batch.clear();
+	}
+	unlockLog();
+	return 0;
+}
+
+/**
+ * Writes all queued log messages to the log file and stops the writer thread.
+ * Messages logged afterwards are written immediately.
+ */
+void flushLog()
+{
+	lockLog();
+	SDL_Thread *writer = logWriter;
+	logWriter = 0;
+	logWriterQuit = true;
+	if (writer)
+	{
+		SDL_CondSignal(logWake);
+	}
+	unlockLog();
+	if (writer)
+	{
+		SDL_WaitThread(writer, 0);
+	}
+}
+
+/**
+ * Writes all queued log messages to the log file from a crash handler.
+ * The writer thread is not waited for, it might be the one that crashed,
+ * and nothing is written if another thread is holding the log lock.
+ * Messages logged afterwards are written immediately.
+ */
+static void flushLogOnCrash()
+{
+	if (!tryLockLog())
+	{
+		return;
+	}
+	logWriter = 0;
+	logWriterQuit = true;
+	std::string data;
+	data.swap(logPending);
+	std::string fileName = logFileName;
+	unlockLog();
+	if (!data.empty() && !logToFile(fileName, data))
+	{
+		fwrite(data.c_str(), data.size(), 1, stderr);
+	}
+}
+
 /**
  * Setting the log file name and setting the effective reportingLevel
  * to not LOG_UNCENSORED turns off buffering of the log messages,
@@ -1616,11 +1935,17 @@ void setLogFileName(const std::string& name) {
 	logFileName = name;
 }
 void log(int level, const std::ostringstream& baremsgstream) {
-	std::ostringstream msgstream;
-	msgstream << "[" << CrossPlatform::now() << "]" << "\t"
-			  << "[" << Logger::toString(level) << "]" << "\t"
-			  << baremsgstream.str() << std::endl;
-	auto msg = msgstream.str();
+	std::string msg;
+	msg += "[";
+	msg += CrossPlatform::now();
+	msg += "]\t[";
+	msg += Logger::toString(level);
+	msg += "]\t";
+	msg += baremsgstream.str();
+	msg += "\n";
+
+	lockLog();
+	struct Unlock { ~Unlock() { unlockLog(); } } unlock;
 
 	int effectiveLevel = Logger::reportingLevel();
 	if (effectiveLevel >= LOG_DEBUG) {
@@ -1634,22 +1959,34 @@ void log(int level, const std::ostringstream& baremsgstream) {
 		logBuffer.push_back(std::make_pair(level, msg));
 		return;
 	}
-	// attempt to flush the buffer
-	bool failed = false;
+	// queue messages accumulated before the log file was known
 	while (!logBuffer.empty()) {
 		if (effectiveLevel >= logBuffer.front().first) {
-			if (!logToFile(logFileName, logBuffer.front().second)) {
-				std::string err = "Failed to append to '" + logFileName + "': " + SDL_GetError();
-				logBuffer.push_back(std::make_pair(LOG_ERROR, err));
-				failed = true;
-				break;
-			}
+			logPending += logBuffer.front().second;
 		}
 		logBuffer.pop_front();
 	}
-	// retain the current message if write fails.
-	if (failed || !logToFile(logFileName, msg)) {
-		logBuffer.push_back(std::make_pair(level, msg));
+	logPending += msg;
+
+	if (!logWriter && !logWriterQuit) {
+		logPending.reserve(LOG_PENDING_RESERVE);
+		logWake = SDL_CreateCond();
+		logWriter = logWake ? SDL_CreateThread(logWriterThread, 0) : 0;
+		if (logWriter) {
+			atexit(flushLog);
+		} else {
+			logWriterQuit = true;
+		}
+	}
+	if (logWriter) {
+		SDL_CondSignal(logWake);
+	} else {
+		// writer is stopped, after a crash or at exit
+		std::string data;
+		data.swap(logPending);
+		if (!logToFile(logFileName, data)) {
+			logRetain(data);
+		}
 	}
 }
 
@@ -37,6 +37,7 @@ class RawData
 {
 	std::unique_ptr<void, RawDataDeleteFun> _data;
 	std::size_t _size;
+	std::shared_ptr<const void> _owner;
 
 
 public:
@@ -53,6 +54,12 @@ public:
 
 	}
 
+	/// Create read-only view of data kept alive by owner.
+	RawData(std::shared_ptr<const void> owner, const void* data, std::size_t size) : _data{ const_cast<void*>(data), +[](void*){} }, _size{ size }, _owner{ std::move(owner) }
+	{
+
+	}
+
 	/// Move constructor.
 	RawData(RawData&& d) : RawData()
 	{
@@ -64,6 +71,7 @@ public:
 	{
 		_data = std::exchange(d._data, std::unique_ptr<void, RawDataDeleteFun>{ nullptr, +[](void*){} });
 		_size = std::exchange(d._size, 0u);
+		_owner = std::move(d._owner);
 
 		return *this;
 	}
@@ -79,6 +87,43 @@ public:
 	void* data() { return _data.get(); }
 };
 
+/**
+ * Read-only view of a buffer kept alive by a shared owner,
+ * like a memory mapped file or a cached decompressed file.
+ */
+class RawSpan
+{
+	std::shared_ptr<const void> _owner;
+	const void* _data;
+	std::size_t _size;
+
+public:
+
+	/// Default constructor.
+	RawSpan() : _owner{ }, _data{ nullptr }, _size{ }
+	{
+
+	}
+
+	/// Create view of data owned by owner.
+	RawSpan(std::shared_ptr<const void> owner, const void* data, std::size_t size) : _owner{ std::move(owner) }, _data{ data }, _size{ size }
+	{
+
+	}
+
+	/// Is there any data?
+	explicit operator bool() const { return _data != nullptr; }
+
+	/// Size of buffer.
+	std::size_t size() const { return _size; }
+
+	/// Data of buffer.
+	const void* data() const { return _data; }
+
+	/// Owner of buffer.
+	const std::shared_ptr<const void>& owner() const { return _owner; }
+};
+
 /**
  * Stream to raw data buffer, owning its data buffer.
  */
@@ -230,6 +275,8 @@ namespace CrossPlatform
 	bool isQuitShortcut(const SDL_Event &ev);
 	/// Gets the modified date of a file.
 	time_t getDateModified(const std::string &path);
+	/// Gets the size of a file.
+	Uint64 getFileSize(const std::string &path);
 	/// Converts a timestamp to a string.
 	std::pair<std::string, std::string> timeToString(time_t time);
 	/// Move/rename a file between paths.
@@ -243,6 +290,8 @@ namespace CrossPlatform
 	std::unique_ptr<std::istream> readFile(const std::string& filename);
 	/// Reads in a file
 	RawData readFileRaw(const std::string& filename);
+	/// Maps a file to memory
+	RawSpan mapFileRaw(const std::string& filename);
 	/// Reads file until "\n---" sequence is met or to the end. To be used only for savegames.
 	std::unique_ptr<std::istream> getYamlSaveHeader (const std::string& filename);
 	/// Reads file until "\n---" sequence is met or to the end. To be used only for savegames.
@@ -257,12 +306,16 @@ namespace CrossPlatform
 	void stackTrace(void *ctx);
 	/// Produces a quick timestamp.
 	std::string now();
+	/// Gets the peak resident memory of the process.
+	size_t getPeakMemory();
 	/// Produces a crash dump.
 	void crashDump(void *ex, const std::string &err);
 	/// Opens a URL.
 	bool openExplorer(const std::string &url);
 	/// Log something.
 	void log(int, const std::ostringstream& msg);
+	/// Writes all queued log messages to the log file.
+	void flushLog();
 	/// The log file name
 	void setLogFileName(const std::string &path);
 	const std::string& getLogFileName();
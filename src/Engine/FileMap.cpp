@@ -41,6 +41,8 @@
 #include <istream>
 #include <unordered_map>
 #include <unordered_set>
+#include <list>
+#include <SDL_mutex.h>
 
 #include "FileMap.h"
 #include "Unicode.h"
@@ -48,6 +50,7 @@
 #include "CrossPlatform.h"
 #include "Options.h"
 #include "Exception.h"
+#include "AssetCache.h"
 
 #define MINIZ_NO_STDIO
 #include "../../libs/miniz/miniz.h"
@@ -176,6 +179,125 @@ namespace OpenXcom
 namespace FileMap
 {
 
+/**
+ * Guards the shared zip decompression contexts and the VFS itself,
+ * so files can be read by background loaders while the main thread
+ * does the same or remaps the mods. SDL mutexes are recursive.
+ */
+static SDL_mutex *vfsMutex()
+{
+	static SDL_mutex *mutex = SDL_CreateMutex();
+	return mutex;
+}
+struct VFSLock
+{
+	VFSLock() { SDL_mutexP(vfsMutex()); }
+	~VFSLock() { SDL_mutexV(vfsMutex()); }
+};
+
+/**
+ * RWops over a read-only span, keeping the owner of the memory
+ * (a mapped file or a cached zip entry) alive until it's closed.
+ */
+struct SpanRWops
+{
+	SDL_RWops rw;
+	std::shared_ptr<const void> owner;
+};
+static int spanops_close(SDL_RWops *context)
+{
+	delete reinterpret_cast<SpanRWops*>(context);
+	return 0;
+}
+static SDL_RWops *SDL_RWFromSpan(const RawSpan &span)
+{
+	if (!span) { return NULL; }
+	SDL_RWops *mem = SDL_RWFromConstMem(span.data(), (int)span.size());
+	if (!mem) { return NULL; }
+	auto *rv = new SpanRWops{ *mem, span.owner() };
+	SDL_FreeRW(mem);
+	rv->rw.close = spanops_close;
+	return &rv->rw;
+}
+
+/**
+ * Recently used decompressed zip entries, most recent first.
+ * Assets that are read more than once only get inflated once,
+ * as long as they fit in the `oxceZipCacheSize` budget.
+ * Only used with the VFS lock held.
+ */
+typedef std::pair<const void *, size_t> ZipEntryKey;
+struct ZipEntryKeyHash
+{
+	size_t operator()(const ZipEntryKey &key) const { return std::hash<const void *>()(key.first) ^ (key.second * 2654435761u); }
+};
+static std::list<std::pair<ZipEntryKey, RawSpan>> ZipCacheLru;
+static std::unordered_map<ZipEntryKey, decltype(ZipCacheLru)::iterator, ZipEntryKeyHash> ZipCacheIndex;
+static size_t ZipCacheBytes = 0;
+
+static void clearZipCache()
+{
+	ZipCacheLru.clear();
+	ZipCacheIndex.clear();
+	ZipCacheBytes = 0;
+}
+
+/**
+ * Finds the decompressed data of a zip entry in the cache.
+ * @param zip Zip context.
+ * @param findex Index of the entry.
+ * @return Entry data, empty if not cached.
+ */
+static RawSpan findZipEntry(mz_zip_archive *zip, size_t findex)
+{
+	auto it = ZipCacheIndex.find(ZipEntryKey{ zip, findex });
+	if (it != ZipCacheIndex.end())
+	{
+		ZipCacheLru.splice(ZipCacheLru.begin(), ZipCacheLru, it->second);
+		return it->second->second;
+	}
+	return RawSpan();
+}
+
+/**
+ * Gets the decompressed data of a zip entry, from the cache if possible.
+ * @param zip Zip context.
+ * @param findex Index of the entry.
+ * @return Entry data, empty on error (see mz_zip_get_last_error).
+ */
+static RawSpan getZipEntry(mz_zip_archive *zip, size_t findex)
+{
+	if (auto span = findZipEntry(zip, findex))
+	{
+		return span;
+	}
+
+	ZipEntryKey key{ zip, findex };
+	size_t size;
+	void *data = mz_zip_reader_extract_to_heap(zip, findex, &size, 0);
+	if (data == NULL)
+	{
+		return RawSpan();
+	}
+	RawSpan span(std::shared_ptr<const void>(data, [](const void *p) { mz_free(const_cast<void *>(p)); }), data, size);
+
+	// big entries would push out everything else
+	size_t budget = (size_t)std::max(0, Options::oxceZipCacheSize) * 1024 * 1024;
+	if (size <= budget / 4)
+	{
+		ZipCacheLru.emplace_front(key, span);
+		ZipCacheIndex[key] = ZipCacheLru.begin();
+		ZipCacheBytes += size;
+		while (ZipCacheBytes > budget)
+		{
+			ZipCacheBytes -= ZipCacheLru.back().second.size();
+			ZipCacheIndex.erase(ZipCacheLru.back().first);
+			ZipCacheLru.pop_back();
+		}
+	}
+	return span;
+}
+
 static inline std::string concatPaths(const std::string& basePath, const std::string& relativePath)
 {
 	if(basePath.size() == 0) throw Exception("Need correct basePath");
@@ -209,9 +331,10 @@ FileRecord::FileRecord() : fullpath(""), zip(NULL), findex(0) { }
 
 SDL_RWops *FileRecord::getRWops() const
 {
+	VFSLock lock;
 	SDL_RWops *rv;
 	if (zip != NULL) {
-		rv = SDL_RWFromMZ((mz_zip_archive *)zip, findex);
+		rv = SDL_RWFromSpan(getSpan());
 	} else {
 		rv = SDL_RWFromFile(fullpath.c_str(), "rb");
 	}
@@ -221,47 +344,42 @@ SDL_RWops *FileRecord::getRWops() const
 
 SDL_RWops *FileRecord::getRWopsReadAll() const
 {
-	SDL_RWops *rv;
-	if (zip != NULL)
+	VFSLock lock;
+	SDL_RWops *rv = NULL;
+	try
 	{
-		rv = SDL_RWFromMZ((mz_zip_archive *)zip, findex);
+		rv = SDL_RWFromSpan(getSpan());
 	}
-	else
+	catch (Exception &)
 	{
-		rv = SDL_RWFromFile(fullpath.c_str(), "rb");
-		if (rv)
-		{
-			size_t size = 0;
-			auto data = SDL_LoadFile_RW(rv, &size, SDL_TRUE);
-			if (data)
-			{
-				rv = SDL_RWFromConstMem(data, size);
-
-				//close callback
-				rv->close = [](struct SDL_RWops *context)
-				{
-					if (context)
-					{
-						//HACK: technically speaking `hidden` is an implementation detail, but we need to use it to deallocate memory (similar to `mzops_close`)
-						if (context->hidden.mem.base)
-						{
-							SDL_free(context->hidden.mem.base);
-						}
-						SDL_FreeRW(context);
-					}
-					return 0;
-				};
-			}
-			else
-			{
-				rv = nullptr;
-			}
-		}
+		// already logged
 	}
 	if (!rv) { Log(LOG_ERROR) << "FileRecord::getRWopsReadAll(): err=" << SDL_GetError(); }
 	return rv;
 }
 
+RawSpan FileRecord::getSpan() const
+{
+	if (zip != NULL)
+	{
+		VFSLock lock;
+		auto span = getZipEntry((mz_zip_archive *)zip, findex);
+		if (!span)
+		{
+			SDL_SetError("miniz extract: %s", mz_zip_get_error_string(mz_zip_get_last_error((mz_zip_archive *)zip)));
+		}
+		return span;
+	}
+	auto span = CrossPlatform::mapFileRaw(fullpath);
+	if (!span)
+	{
+		// empty files, or platforms without mapping
+		auto data = std::make_shared<RawData>(CrossPlatform::readFileRaw(fullpath));
+		span = RawSpan(data, data->data(), data->size());
+	}
+	return span;
+}
+
 std::unique_ptr<std::istream> FileRecord::getIStream() const
 {
 	if (zip != NULL) {
@@ -271,25 +389,52 @@ std::unique_ptr<std::istream> FileRecord::getIStream() const
 	}
 }
 
-RawData FileRecord::getUnzippedData() const
+RawData FileRecord::getUnzippedData(bool cache) const
 {
-	size_t size;
-	void* data = mz_zip_reader_extract_to_heap((mz_zip_archive*)zip, findex, &size, 0);
-	if (data == NULL)
+	VFSLock lock;
+	auto span = cache ? getZipEntry((mz_zip_archive*)zip, findex) : findZipEntry((mz_zip_archive*)zip, findex);
+	if (span)
 	{
-		auto err = "FileRecord::getIStream(): failed to decompress " + fullpath + ": ";
-		err += mz_zip_get_error_string(mz_zip_get_last_error((mz_zip_archive*)zip));
-		Log(LOG_FATAL) << err;
-		throw Exception(err);
+		// shares the buffer with the cache
+		return RawData(span.owner(), span.data(), span.size());
+	}
+	if (!cache)
+	{
+		size_t size;
+		void *data = mz_zip_reader_extract_to_heap((mz_zip_archive*)zip, findex, &size, 0);
+		if (data != NULL)
+		{
+			return RawData(data, size, mz_free);
+		}
 	}
-	return RawData(data, size, mz_free);
+	auto err = "FileRecord::getIStream(): failed to decompress " + fullpath + ": ";
+	err += mz_zip_get_error_string(mz_zip_get_last_error((mz_zip_archive*)zip));
+	Log(LOG_FATAL) << err;
+	throw Exception(err);
+}
+
+Uint64 FileRecord::getStamp() const
+{
+	if (zip != NULL)
+	{
+		VFSLock lock;
+		mz_zip_archive_file_stat fistat;
+		if (!mz_zip_reader_file_stat((mz_zip_archive*)zip, findex, &fistat))
+		{
+			return 0;
+		}
+		return ((Uint64)fistat.m_crc32 << 32) ^ fistat.m_uncomp_size;
+	}
+	// files are often replaced by ones with an older date, the size catches most of them
+	return (CrossPlatform::getFileSize(fullpath) << 32) ^ (Uint64)CrossPlatform::getDateModified(fullpath);
 }
 
 YAML::YamlRootNodeReader FileRecord::getYAML() const
 {
 	try
 	{
-		RawData data = zip != NULL ? getUnzippedData() : CrossPlatform::readFileRaw(fullpath);
+		// rulesets are read once, keep them out of the asset cache
+		RawData data = zip != NULL ? getUnzippedData(false) : CrossPlatform::readFileRaw(fullpath);
 		return YAML::YamlRootNodeReader(data, fullpath);
 	}
 	catch(...)
@@ -299,6 +444,17 @@ YAML::YamlRootNodeReader FileRecord::getYAML() const
 	}
 }
 
+YAML::YamlRootNodeReader FileRecord::getYAML(const AssetCache *snapshots, Uint64 key) const
+{
+	size_t size = 0;
+	const Uint8 *snapshot = snapshots ? snapshots->findAny(key, size) : nullptr;
+	if (snapshot && YAML::YamlRootNodeReader::isValidSnapshot(snapshot, size))
+	{
+		return YAML::YamlRootNodeReader(snapshot, size, fullpath);
+	}
+	return getYAML();
+}
+
 std::vector<YAML::YamlNodeReader> FileRecord::getAllYAML() const
 {
 	Log(LOG_FATAL) << "Error loading file '" << fullpath << "'";
@@ -729,11 +885,13 @@ static mz_zip_archive *newZipContext(const std::string& log_ctx, SDL_RWops *rwop
 }
 
 void clear(bool clearOnly, bool embeddedOnly) {
+	VFSLock lock;
 	TheVFS.clear();
 	for (auto i : ModsAvailable ) { delete i.second; }
 	ModsAvailable.clear();
 	for (auto i : MappedVFSLayers ) { delete i; }
 	MappedVFSLayers.clear();
+	clearZipCache();
 	for (auto i : ZipContexts) { mz_zip_reader_end_rwops(i); SDL_free(i); }
 	ZipContexts.clear();
 	if (!clearOnly)
@@ -755,6 +913,7 @@ void clear(bool clearOnly, bool embeddedOnly) {
 */
 void setup(const std::vector<const ModInfo* >& active, bool embeddedOnly)
 {
+	VFSLock lock;
 	TheVFS.clear();
 	TheVFS.map_common(embeddedOnly);
 	std::string log_ctx = "FileMap::setup(): ";
@@ -1288,12 +1447,19 @@ const FileRecord *at(const std::string &relativeFilePath) {
 
 SDL_RWops *getRWops(const std::string &relativeFilePath)
 {
+	VFSLock lock;
 	return at(relativeFilePath)->getRWops();
 }
 SDL_RWops *getRWopsReadAll(const std::string &relativeFilePath)
 {
+	VFSLock lock;
 	return at(relativeFilePath)->getRWopsReadAll();
 }
+RawSpan getSpan(const std::string &relativeFilePath)
+{
+	VFSLock lock;
+	return at(relativeFilePath)->getSpan();
+}
 
 std::unique_ptr<std::istream> getIStream(const std::string &relativeFilePath) {
 	return at(relativeFilePath)->getIStream();
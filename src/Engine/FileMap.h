@@ -32,6 +32,8 @@
 namespace OpenXcom
 {
 
+class AssetCache;
+
 /**
  * Maps canonical names to file paths and maintains the virtual file system
  * for resource files.
@@ -52,8 +54,15 @@ namespace FileMap
 		SDL_RWops *getRWopsReadAll() const;
 
 		std::unique_ptr<std::istream> getIStream() const;
-		RawData getUnzippedData() const;
+		/// Gets the decompressed data of a zip entry, cache it for later reads if asked.
+		RawData getUnzippedData(bool cache = true) const;
+		/// Gets a read-only view of the whole file, mapped or cached without copying where possible.
+		RawSpan getSpan() const;
+		/// Gets a value that changes when the file contents change, without reading it.
+		Uint64 getStamp() const;
 		YAML::YamlRootNodeReader getYAML() const;
+		/// Restores the parsed file from a snapshot in the cache, or parses it if there's no valid one.
+		YAML::YamlRootNodeReader getYAML(const AssetCache *snapshots, Uint64 key) const;
 		std::vector<YAML::YamlNodeReader> getAllYAML() const;
 	};
 
@@ -69,6 +78,9 @@ namespace FileMap
 	/// Gets SDL_RWops for the file data of a data file blah blah read above. Reads the whole file to memory.
 	SDL_RWops *getRWopsReadAll(const std::string &relativeFilePath);
 
+	/// Gets a read-only view of the whole file data, without copying it where possible.
+	RawSpan getSpan(const std::string &relativeFilePath);
+
 	/// Gets an std::istream interface to the file data. Has to be deleted on the caller's end.
 	std::unique_ptr<std::istream>getIStream(const std::string &relativeFilePath);
 
@@ -38,6 +38,7 @@
 #include "Options.h"
 #include "CrossPlatform.h"
 #include "FileMap.h"
+#include "Profiler.h"
 #include "Unicode.h"
 #include "../Ufopaedia/UfopaediaStartState.h"
 #include "../Menu/NotesState.h"
@@ -180,6 +181,7 @@ void Game::run()
 		}
 
 		// Process events
+		ProfileScope profileEvents("Game::events");
 		while (SDL_PollEvent(&_event))
 		{
 			if (CrossPlatform::isQuitShortcut(_event))
@@ -303,6 +305,11 @@ void Game::run()
 								}
 							}
 						}
+						// "ctrl-alt-p" export profiler trace
+						else if (action.getDetails()->key.keysym.sym == SDLK_p && isCtrlPressed() && isAltPressed() && Options::oxceProfiler)
+						{
+							Profiler::exportTrace(Options::getUserFolder() + "trace_" + CrossPlatform::now() + ".json");
+						}
 						else if (Options::debug)
 						{
 							if (action.getDetails()->key.keysym.sym == SDLK_t && isCtrlPressed())
@@ -327,12 +334,16 @@ void Game::run()
 				break;
 			}
 		}
+		profileEvents.end();
 
 		// Process rendering
 		if (runningState != PAUSED)
 		{
 			// Process logic
-			_states.back()->think();
+			{
+				ProfileScope profile("Game::think");
+				_states.back()->think();
+			}
 			_fpsCounter->think();
 			if (Options::FPS > 0 && !(Options::useOpenGL && Options::vSyncForOpenGL))
 			{
@@ -348,6 +359,7 @@ void Game::run()
 
 			if (_init && _timeUntilNextFrame <= 0)
 			{
+				ProfileScope profile("Game::blit");
 				// make a note of when this frame update occurred.
 				_timeOfLastFrame = SDL_GetTicks();
 				_fpsCounter->addFrame();
@@ -380,6 +392,10 @@ void Game::run()
 		}
 	}
 
+	if (Options::oxceProfiler)
+	{
+		Profiler::exportTrace(Options::getUserFolder() + "trace_" + CrossPlatform::now() + ".json");
+	}
 	Options::save();
 }
 
@@ -0,0 +1,228 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "ImagePrefetcher.h"
+#include <exception>
+#include "Surface.h"
+#include "CrossPlatform.h"
+#include "Logger.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Creates an idle prefetcher, the worker thread is started with the first request.
+ */
+ImagePrefetcher::ImagePrefetcher() : _order(0), _quit(false), _mutex(SDL_CreateMutex()), _cond(SDL_CreateCond()), _thread(nullptr)
+{
+}
+
+/**
+ * Waits for the worker to finish the current image and frees everything.
+ */
+ImagePrefetcher::~ImagePrefetcher()
+{
+	if (_thread)
+	{
+		SDL_mutexP(_mutex);
+		_quit = true;
+		SDL_CondBroadcast(_cond);
+		SDL_mutexV(_mutex);
+		SDL_WaitThread(_thread, nullptr);
+	}
+	SDL_DestroyCond(_cond);
+	SDL_DestroyMutex(_mutex);
+}
+
+/**
+ * Entry point of the worker thread.
+ * @param data Pointer to the prefetcher.
+ * @return Thread exit code.
+ */
+int ImagePrefetcher::worker(void *data)
+{
+	((ImagePrefetcher*)data)->run();
+	return 0;
+}
+
+/**
+ * Takes jobs from the queue, highest priority first, and decodes them
+ * with the lock released so the main thread is never blocked by it.
+ */
+void ImagePrefetcher::run()
+{
+	SDL_mutexP(_mutex);
+	while (!_quit)
+	{
+		if (_jobs.empty())
+		{
+			SDL_CondWait(_cond, _mutex);
+			continue;
+		}
+		std::string filename = _jobs.top().filename;
+		_jobs.pop();
+
+		// already taken, or queued again with other priority
+		auto i = _entries.find(filename);
+		if (i == _entries.end() || i->second.state != ENTRY_QUEUED)
+		{
+			continue;
+		}
+		i->second.state = ENTRY_DECODING;
+		SDL_mutexV(_mutex);
+
+		auto surface = std::make_unique<Surface>();
+		bool decoded = false;
+		try
+		{
+			decoded = surface->loadPng(filename);
+		}
+		catch (std::exception &e)
+		{
+			// the main thread will load it again and report it properly
+			Log(LOG_DEBUG) << "Prefetching " << filename << " failed: " << e.what();
+		}
+		catch (...)
+		{
+			Log(LOG_DEBUG) << "Prefetching " << filename << " failed";
+		}
+
+		SDL_mutexP(_mutex);
+		i = _entries.find(filename);
+		if (i != _entries.end())
+		{
+			if (i->second.state == ENTRY_CANCELLED)
+			{
+				// dropped while it was decoded
+				_entries.erase(i);
+			}
+			else if (i->second.state == ENTRY_DECODING)
+			{
+				i->second.state = decoded ? ENTRY_DONE : ENTRY_FAILED;
+				i->second.surface = decoded ? std::move(surface) : nullptr;
+			}
+		}
+		SDL_CondBroadcast(_cond);
+	}
+	SDL_mutexV(_mutex);
+}
+
+/**
+ * Queues an image file for decoding. Files already queued are moved
+ * to the new priority if it's higher, other than PNG are ignored.
+ * @param filename Filename of the image.
+ * @param priority Bigger numbers are decoded first.
+ */
+void ImagePrefetcher::request(const std::string &filename, int priority)
+{
+	if (!CrossPlatform::compareExt(filename, "png"))
+	{
+		return;
+	}
+
+	SDL_mutexP(_mutex);
+	auto i = _entries.find(filename);
+	if (i == _entries.end())
+	{
+		_entries[filename].state = ENTRY_QUEUED;
+		_jobs.push(Job{ priority, _order++, filename });
+	}
+	else if (i->second.state == ENTRY_QUEUED)
+	{
+		// the old job stays in the queue, whichever comes first wins
+		_jobs.push(Job{ priority, _order++, filename });
+	}
+	SDL_CondBroadcast(_cond);
+	SDL_mutexV(_mutex);
+
+	if (!_thread)
+	{
+		_thread = SDL_CreateThread(worker, (void*)this);
+		if (!_thread)
+		{
+			Log(LOG_ERROR) << "ImagePrefetcher: " << SDL_GetError();
+		}
+	}
+}
+
+/**
+ * Moves a decoded image into a surface. Waits if it's being decoded right now,
+ * images still waiting in the queue are dropped so the caller can load them right away.
+ * @param filename Filename of the image.
+ * @param surface Surface replaced by the image.
+ * @return True if the image was ready, false if the caller needs to load it.
+ */
+bool ImagePrefetcher::take(const std::string &filename, Surface *surface)
+{
+	SDL_mutexP(_mutex);
+	auto i = _entries.find(filename);
+	while (i != _entries.end() && i->second.state == ENTRY_DECODING)
+	{
+		SDL_CondWait(_cond, _mutex);
+		i = _entries.find(filename);
+	}
+	bool ready = false;
+	if (i != _entries.end())
+	{
+		if (i->second.state == ENTRY_DONE)
+		{
+			*surface = std::move(*i->second.surface);
+			ready = true;
+		}
+		_entries.erase(i);
+	}
+	SDL_mutexV(_mutex);
+	return ready;
+}
+
+/**
+ * Drops all queued and decoded images, the one being decoded is marked
+ * as cancelled and dropped by the worker when finished.
+ */
+void ImagePrefetcher::clear()
+{
+	SDL_mutexP(_mutex);
+	_jobs = std::priority_queue<Job>();
+	for (auto i = _entries.begin(); i != _entries.end();)
+	{
+		if (i->second.state == ENTRY_DECODING || i->second.state == ENTRY_CANCELLED)
+		{
+			i->second.state = ENTRY_CANCELLED;
+			++i;
+		}
+		else
+		{
+			i = _entries.erase(i);
+		}
+	}
+	SDL_mutexV(_mutex);
+}
+
+/**
+ * Gets the number of images queued or waiting to be taken.
+ * @return Number of images.
+ */
+size_t ImagePrefetcher::getPending()
+{
+	SDL_mutexP(_mutex);
+	size_t pending = _entries.size();
+	SDL_mutexV(_mutex);
+	return pending;
+}
+
+}
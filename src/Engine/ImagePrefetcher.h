@@ -0,0 +1,88 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <queue>
+#include <memory>
+#include <unordered_map>
+#include <SDL.h>
+#include <SDL_thread.h>
+
+namespace OpenXcom
+{
+
+class Surface;
+
+/**
+ * Decodes image files on a background thread ahead of their first use,
+ * so lazily loaded sprites don't stall the game when they're needed.
+ * Files are decoded in order of priority into standalone surfaces
+ * that the main thread later takes over instead of loading the file itself.
+ * Only PNG files are handled, they don't need SDL_image.
+ */
+class ImagePrefetcher
+{
+private:
+	enum EntryState { ENTRY_QUEUED, ENTRY_DECODING, ENTRY_CANCELLED, ENTRY_DONE, ENTRY_FAILED };
+	struct Entry
+	{
+		EntryState state;
+		std::unique_ptr<Surface> surface;
+	};
+	struct Job
+	{
+		int priority;
+		Uint32 order;
+		std::string filename;
+
+		bool operator<(const Job &other) const
+		{
+			// higher priority first, then first come first served
+			return priority != other.priority ? priority < other.priority : order > other.order;
+		}
+	};
+
+	std::unordered_map<std::string, Entry> _entries;
+	std::priority_queue<Job> _jobs;
+	Uint32 _order;
+	bool _quit;
+	SDL_mutex *_mutex;
+	SDL_cond *_cond;
+	SDL_Thread *_thread;
+
+	/// Entry point of the worker thread.
+	static int worker(void *data);
+	/// Decodes queued files until asked to quit.
+	void run();
+public:
+	/// Creates an idle prefetcher.
+	ImagePrefetcher();
+	/// Stops the worker and frees all decoded images.
+	~ImagePrefetcher();
+	/// Queues an image file for decoding.
+	void request(const std::string &filename, int priority);
+	/// Moves a decoded image into a surface.
+	bool take(const std::string &filename, Surface *surface);
+	/// Drops all queued and decoded images.
+	void clear();
+	/// Gets the number of images queued or waiting to be taken.
+	size_t getPending();
+};
+
+}
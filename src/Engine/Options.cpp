@@ -27,6 +27,7 @@
 #include <sstream>
 #include <iostream>
 #include <algorithm>
+#include <cstdlib>
 #include "../Engine/Yaml.h"
 #include "Exception.h"
 #include "Logger.h"
@@ -34,6 +35,7 @@
 #include "../Menu/ModConfirmExtendedState.h"
 #include "FileMap.h"
 #include "Screen.h"
+#include "Profiler.h"
 
 namespace OpenXcom
 {
@@ -56,6 +58,9 @@ std::string _masterMod;
 int _passwordCheck = -1;
 bool _loadLastSave = false;
 std::string _loadThisSave = "";
+int _benchmarkRuns = 0;
+int _benchmarkStartupRuns = 0;
+int _benchmarkLoadRuns = 0;
 bool _loadLastSaveExpended = false;
 
 /**
@@ -369,6 +374,13 @@ void createOptionsOXCE()
 	_info.push_back(OptionInfo(OPTION_OXCE, "oxceEmbeddedOnly", &oxceEmbeddedOnly, true));
 	_info.push_back(OptionInfo(OPTION_OXCE, "oxceListVFSContents", &oxceListVFSContents, false));
 	_info.push_back(OptionInfo(OPTION_OXCE, "oxceEnablePaletteFlickerFix", &oxceEnablePaletteFlickerFix, false));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceSpriteAtlas", &oxceSpriteAtlas, true));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxcePrefetchResources", &oxcePrefetchResources, true));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceAssetCache", &oxceAssetCache, true));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceRulesetCache", &oxceRulesetCache, false));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceZipCacheSize", &oxceZipCacheSize, 64)); // in MB
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceScriptProfiler", &oxceScriptProfiler, false));
+	_info.push_back(OptionInfo(OPTION_OXCE, "oxceProfiler", &oxceProfiler, false));
 	_info.push_back(OptionInfo(OPTION_OXCE, "oxceRecommendedOptionsWereSet", &oxceRecommendedOptionsWereSet, false));
 	_info.push_back(OptionInfo(OPTION_OXCE, "password", &password, "secret"));
 
@@ -727,6 +739,18 @@ static void loadArgs()
 					_loadLastSave = true;
 					_loadThisSave = argv[i];
 				}
+				else if (argname == "benchmark")
+				{
+					_benchmarkRuns = std::max(std::atoi(argv[i].c_str()), 1);
+				}
+				else if (argname == "benchmark-startup")
+				{
+					_benchmarkStartupRuns = std::max(std::atoi(argv[i].c_str()), 1);
+				}
+				else if (argname == "benchmark-load")
+				{
+					_benchmarkLoadRuns = std::max(std::atoi(argv[i].c_str()), 1);
+				}
 				else
 				{
 					//save this command line option for now, we will apply it later
@@ -765,6 +789,12 @@ static bool showHelp()
 	help << "        load last save" << std::endl << std::endl;
 	help << "-load FILENAME" << std::endl;
 	help << "        load the specified FILENAME (from the corresponding master mod subfolder)" << std::endl << std::endl;
+	help << "-benchmark RUNS" << std::endl;
+	help << "        time the battlescape engine RUNS times on the battle given by -load, then quit" << std::endl << std::endl;
+	help << "-benchmark-startup RUNS" << std::endl;
+	help << "        load the game data RUNS times without a display, log the time of each phase, then quit" << std::endl << std::endl;
+	help << "-benchmark-load RUNS" << std::endl;
+	help << "        load the save given by -load RUNS times without a display, log the time and YAML allocations, then quit" << std::endl << std::endl;
 	help << "-version" << std::endl;
 	help << "        show version number" << std::endl << std::endl;
 	help << "-help" << std::endl;
@@ -845,6 +875,7 @@ bool init()
 {
 	if (showHelp())
 		return false;
+	ProfilePhase phase("Options::init");
 	create();
 	resetDefault(true);
 	loadArgs();
@@ -1070,7 +1101,10 @@ void updateMods()
 	// pick up stuff in common before-hand
 	FileMap::clear(false, Options::oxceEmbeddedOnly);
 
-	refreshMods();
+	{
+		ProfilePhase phase("Scanning mods");
+		refreshMods();
+	}
 
 	// check active mods that don't meet the enforced OXCE requirements
 	auto* masterInf = getActiveMasterInfo();
@@ -1104,7 +1138,9 @@ void updateMods()
 		throw Exception("Incompatible mods are active. Please upgrade OpenXcom.");
 	}
 
+	ProfilePhase phase("FileMap::setup");
 	FileMap::setup(activeModsList, Options::oxceEmbeddedOnly);
+	phase.end();
 	userSplitMasters();
 
 	Log(LOG_INFO) << "Active mods:";
@@ -1172,6 +1208,62 @@ const std::string& getLoadThisSave()
 	return _loadThisSave;
 }
 
+int getBenchmarkRuns()
+{
+	return _benchmarkRuns;
+}
+
+/**
+ * Checks that the battlescape benchmark has a battle to run on.
+ * It changes the battle and quits the game, so it must not wait
+ * for whatever battle the player happens to start.
+ * @return False if the benchmark was requested without a battle save.
+ */
+bool checkBenchmarkSave()
+{
+	if (_benchmarkRuns == 0)
+	{
+		return true;
+	}
+	if (_loadThisSave.empty())
+	{
+		Log(LOG_ERROR) << "Battlescape benchmark needs a battle save, given by -load.";
+		return false;
+	}
+	std::string fullname = getMasterUserFolder() + _loadThisSave;
+	if (!CrossPlatform::fileExists(fullname))
+	{
+		Log(LOG_ERROR) << "Battlescape benchmark save not found: " << fullname;
+		return false;
+	}
+	try
+	{
+		// only battle saves have the mission in the header
+		YAML::YamlRootNodeReader reader(fullname, true);
+		if (!reader["mission"])
+		{
+			Log(LOG_ERROR) << "Battlescape benchmark needs a battle save, " << _loadThisSave << " is a geoscape save.";
+			return false;
+		}
+	}
+	catch (std::exception &e)
+	{
+		Log(LOG_ERROR) << "Battlescape benchmark save can't be read: " << e.what();
+		return false;
+	}
+	return true;
+}
+
+int getBenchmarkStartupRuns()
+{
+	return _benchmarkStartupRuns;
+}
+
+int getBenchmarkLoadRuns()
+{
+	return _benchmarkLoadRuns;
+}
+
 void expendLoadLastSave()
 {
 	_loadLastSaveExpended = true;
@@ -133,6 +133,14 @@ namespace Options
 	bool getLoadLastSave();
 	/// If we should skip the main menu and just load the specified save
 	const std::string& getLoadThisSave();
+	/// How many times to run the battlescape benchmark, 0 if not requested
+	int getBenchmarkRuns();
+	/// Checks that the battlescape benchmark, if requested, was given a battle save
+	bool checkBenchmarkSave();
+	/// How many times to load the game data for the startup benchmark, 0 if not requested
+	int getBenchmarkStartupRuns();
+	/// How many times to load the save for the save loading benchmark, 0 if not requested
+	int getBenchmarkLoadRuns();
 	/// And do it only at startup
 	void expendLoadLastSave();
 }
@@ -134,6 +134,13 @@ OPT bool oxceDisableThinkingProgressBar;
 OPT bool oxceEmbeddedOnly;
 OPT bool oxceListVFSContents;
 OPT bool oxceEnablePaletteFlickerFix;
+OPT bool oxceSpriteAtlas;
+OPT bool oxcePrefetchResources;
+OPT bool oxceAssetCache;
+OPT bool oxceRulesetCache;
+OPT int oxceZipCacheSize;
+OPT bool oxceScriptProfiler;
+OPT bool oxceProfiler;
 OPT bool oxceRecommendedOptionsWereSet;
 OPT std::string password;
 
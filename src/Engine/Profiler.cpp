@@ -0,0 +1,267 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "Profiler.h"
+#include <chrono>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <SDL_mutex.h>
+#include "CrossPlatform.h"
+#include "Logger.h"
+
+namespace OpenXcom
+{
+
+namespace Profiler
+{
+
+namespace
+{
+
+/// Number of sections kept per thread.
+const size_t RING_SIZE = 1 << 16;
+
+struct Event
+{
+	const char *name;
+	Uint64 start, end;
+};
+
+struct ThreadRing
+{
+	int id;
+	bool inUse;
+	size_t next;
+	bool wrapped;
+	SDL_mutex *mutex;
+	std::vector<Event> events;
+};
+
+/// Rings of all threads that recorded anything, rings of exited threads are reused.
+std::vector<ThreadRing*> rings;
+
+/**
+ * Hands the ring of a thread back for reuse when the thread exits.
+ */
+struct RingOwner
+{
+	ThreadRing *ring = nullptr;
+	~RingOwner();
+};
+/// Ring of the current thread.
+thread_local RingOwner currentRing;
+
+struct Phase
+{
+	std::string name;
+	int depth;
+	Uint64 start, end;
+	size_t peakMemory;
+};
+
+/// Finished phases waiting for the report.
+std::vector<Phase> phases;
+/// Number of phases open in the current thread.
+thread_local int phaseDepth = 0;
+
+SDL_mutex *getPhasesMutex()
+{
+	static SDL_mutex *mutex = SDL_CreateMutex();
+	return mutex;
+}
+
+SDL_mutex *getRingsMutex()
+{
+	static SDL_mutex *mutex = SDL_CreateMutex();
+	return mutex;
+}
+
+/**
+ * Gets the ring of the current thread, taking over the ring
+ * of an exited thread or creating one on first use.
+ */
+ThreadRing *getRing()
+{
+	if (!currentRing.ring)
+	{
+		SDL_mutex *mutex = getRingsMutex();
+		SDL_mutexP(mutex);
+		for (auto *ring : rings)
+		{
+			if (!ring->inUse)
+			{
+				currentRing.ring = ring;
+				break;
+			}
+		}
+		if (!currentRing.ring)
+		{
+			currentRing.ring = new ThreadRing{ (int)rings.size() + 1, false, 0, false, SDL_CreateMutex(), std::vector<Event>(RING_SIZE) };
+			rings.push_back(currentRing.ring);
+		}
+		currentRing.ring->inUse = true;
+		SDL_mutexV(mutex);
+	}
+	return currentRing.ring;
+}
+
+/**
+ * Marks the ring as free for the next thread that records anything.
+ */
+RingOwner::~RingOwner()
+{
+	if (ring)
+	{
+		SDL_mutex *mutex = getRingsMutex();
+		SDL_mutexP(mutex);
+		ring->inUse = false;
+		SDL_mutexV(mutex);
+	}
+}
+
+}
+
+/**
+ * Gets the current time, relative to the first call.
+ * @return Time in microseconds.
+ */
+Uint64 now()
+{
+	static const auto epoch = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+/**
+ * Records a finished section for the current thread.
+ * @param name Section name.
+ * @param start Start time in microseconds.
+ * @param end End time in microseconds.
+ */
+void record(const char *name, Uint64 start, Uint64 end)
+{
+	ThreadRing *ring = getRing();
+	SDL_mutexP(ring->mutex);
+	ring->events[ring->next] = Event{ name, start, end };
+	if (++ring->next == RING_SIZE)
+	{
+		ring->next = 0;
+		ring->wrapped = true;
+	}
+	SDL_mutexV(ring->mutex);
+}
+
+/**
+ * Writes all recorded sections as complete events in the
+ * Chrome trace JSON format, loadable in chrome://tracing or Perfetto.
+ * @param filename Output file.
+ * @return True if the file was written.
+ */
+bool exportTrace(const std::string &filename)
+{
+	std::ostringstream out;
+	size_t total = 0;
+	out << "{\"traceEvents\":[";
+	std::vector<Event> events;
+	SDL_mutex *mutex = getRingsMutex();
+	SDL_mutexP(mutex);
+	for (const auto *ring : rings)
+	{
+		// copy the events out oldest first, the thread keeps recording meanwhile
+		SDL_mutexP(ring->mutex);
+		size_t first = ring->wrapped ? ring->next : 0;
+		events.assign(ring->events.begin() + first, ring->wrapped ? ring->events.end() : ring->events.begin() + ring->next);
+		events.insert(events.end(), ring->events.begin(), ring->events.begin() + first);
+		SDL_mutexV(ring->mutex);
+		for (const auto &e : events)
+		{
+			out << (total ? ",\n" : "\n");
+			out << "{\"name\":\"" << e.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << ring->id << ",\"ts\":" << e.start << ",\"dur\":" << e.end - e.start << "}";
+			++total;
+		}
+	}
+	SDL_mutexV(mutex);
+	out << "\n]}\n";
+
+	if (!CrossPlatform::writeFile(filename, out.str()))
+	{
+		Log(LOG_ERROR) << "Failed to write profiler trace " << filename;
+		return false;
+	}
+	Log(LOG_INFO) << "Profiler trace with " << total << " events written to " << filename;
+	return true;
+}
+
+/**
+ * Opens a phase in the current thread.
+ * @return Nesting depth of the phase.
+ */
+int beginPhase()
+{
+	return phaseDepth++;
+}
+
+/**
+ * Closes a phase and keeps it for the report,
+ * together with the peak memory reached so far.
+ * @param name Phase name.
+ * @param depth Nesting depth from beginPhase().
+ * @param start Start time in microseconds.
+ * @param end End time in microseconds.
+ */
+void endPhase(const std::string &name, int depth, Uint64 start, Uint64 end)
+{
+	--phaseDepth;
+	size_t peakMemory = CrossPlatform::getPeakMemory();
+	SDL_mutex *mutex = getPhasesMutex();
+	SDL_mutexP(mutex);
+	phases.push_back(Phase{ name, depth, start, end, peakMemory });
+	SDL_mutexV(mutex);
+}
+
+/**
+ * Logs all phases closed since the last report in the order
+ * they started, nested phases indented under their parent.
+ * @param title Heading of the report.
+ */
+void logPhases(const std::string &title)
+{
+	SDL_mutex *mutex = getPhasesMutex();
+	SDL_mutexP(mutex);
+	std::vector<Phase> report;
+	report.swap(phases);
+	SDL_mutexV(mutex);
+
+	std::stable_sort(report.begin(), report.end(), [](const Phase &a, const Phase &b) { return a.start < b.start || (a.start == b.start && a.depth < b.depth); });
+	Log(LOG_INFO) << title << ":";
+	for (const auto &phase : report)
+	{
+		std::ostringstream ss;
+		ss << std::string(2 + 2 * phase.depth, ' ') << phase.name << ": " << std::fixed << std::setprecision(1) << (phase.end - phase.start) / 1000.0 << " ms";
+		if (phase.peakMemory)
+		{
+			ss << ", peak memory " << phase.peakMemory / (1024 * 1024) << " MB";
+		}
+		Log(LOG_INFO) << ss.str();
+	}
+}
+
+}
+
+}
@@ -0,0 +1,117 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <SDL_types.h>
+#include "Options.h"
+
+namespace OpenXcom
+{
+
+/**
+ * Records timing of marked code sections and exports them as a
+ * Chrome/Perfetto trace. Every thread writes to its own ring buffer,
+ * the oldest events are overwritten when it is full.
+ */
+namespace Profiler
+{
+	/// Gets the current time in microseconds.
+	Uint64 now();
+	/// Records a finished section for the current thread.
+	void record(const char *name, Uint64 start, Uint64 end);
+	/// Writes all recorded sections to a trace file.
+	bool exportTrace(const std::string &filename);
+	/// Opens a phase for the phase report.
+	int beginPhase();
+	/// Closes a phase and adds it to the phase report.
+	void endPhase(const std::string &name, int depth, Uint64 start, Uint64 end);
+	/// Logs the phase report and clears it.
+	void logPhases(const std::string &title);
+}
+
+/**
+ * Times the enclosing scope while profiling is enabled.
+ * When disabled it costs one option check.
+ */
+class ProfileScope
+{
+	const char *_name;
+	Uint64 _start;
+	bool _active;
+public:
+	/// Starts timing a section, the name must outlive the profiler (use literals).
+	ProfileScope(const char *name) : _name(name), _start(0), _active(Options::oxceProfiler)
+	{
+		if (_active)
+		{
+			_start = Profiler::now();
+		}
+	}
+	/// Records the section.
+	~ProfileScope()
+	{
+		end();
+	}
+	/// Records the section before the end of the scope.
+	void end()
+	{
+		if (_active)
+		{
+			Profiler::record(_name, _start, Profiler::now());
+			_active = false;
+		}
+	}
+	ProfileScope(const ProfileScope&) = delete;
+	ProfileScope &operator=(const ProfileScope&) = delete;
+};
+
+/**
+ * Times a coarse phase like a startup step for the phase report.
+ * Always active, meant for a few dozen phases, not hot code.
+ */
+class ProfilePhase
+{
+	std::string _name;
+	Uint64 _start;
+	int _depth;
+	bool _active;
+public:
+	/// Starts timing a phase.
+	ProfilePhase(const std::string &name) : _name(name), _start(Profiler::now()), _depth(Profiler::beginPhase()), _active(true)
+	{
+	}
+	/// Records the phase.
+	~ProfilePhase()
+	{
+		end();
+	}
+	/// Records the phase before the end of the scope.
+	void end()
+	{
+		if (_active)
+		{
+			Profiler::endPhase(_name, _depth, _start, Profiler::now());
+			_active = false;
+		}
+	}
+	ProfilePhase(const ProfilePhase&) = delete;
+	ProfilePhase &operator=(const ProfilePhase&) = delete;
+};
+
+}
@@ -25,6 +25,7 @@
 #include <array>
 #include <numeric>
 #include <climits>
+#include <chrono>
 
 #include "Logger.h"
 #include "Options.h"
@@ -87,6 +88,30 @@ constexpr bool isKnowNamePrefix(ScriptRef name)
 	MACRO_COPY_64(Func, (Pos) + 0x80) \
 	MACRO_COPY_64(Func, (Pos) + 0xC0)
 
+/**
+ * Same as MACRO_COPY_256 but give two hex digits as separate tokens, this allow to create unique identifiers.
+ */
+#define MACRO_COPY_HEX_16(Func, High) \
+	Func(High, 0) Func(High, 1) Func(High, 2) Func(High, 3) \
+	Func(High, 4) Func(High, 5) Func(High, 6) Func(High, 7) \
+	Func(High, 8) Func(High, 9) Func(High, A) Func(High, B) \
+	Func(High, C) Func(High, D) Func(High, E) Func(High, F)
+#define MACRO_COPY_HEX_256(Func) \
+	MACRO_COPY_HEX_16(Func, 0) MACRO_COPY_HEX_16(Func, 1) MACRO_COPY_HEX_16(Func, 2) MACRO_COPY_HEX_16(Func, 3) \
+	MACRO_COPY_HEX_16(Func, 4) MACRO_COPY_HEX_16(Func, 5) MACRO_COPY_HEX_16(Func, 6) MACRO_COPY_HEX_16(Func, 7) \
+	MACRO_COPY_HEX_16(Func, 8) MACRO_COPY_HEX_16(Func, 9) MACRO_COPY_HEX_16(Func, A) MACRO_COPY_HEX_16(Func, B) \
+	MACRO_COPY_HEX_16(Func, C) MACRO_COPY_HEX_16(Func, D) MACRO_COPY_HEX_16(Func, E) MACRO_COPY_HEX_16(Func, F)
+
+/**
+ * GCC and Clang can jump directly to next operation using label addresses,
+ * other compilers use `switch` in loop.
+ */
+#if defined(__GNUC__)
+#define SCRIPT_THREADED_DISPATCH 1
+#else
+#define SCRIPT_THREADED_DISPATCH 0
+#endif
+
 
 ////////////////////////////////////////////////////////////
 //						proc definition
@@ -437,18 +462,20 @@ enum ProcEnum : Uint8
 /**
  * Core function in script engine used to executing scripts
  * @param proc array storing operation of script
+ * @param instructions counter of executed operations, used only when profiling
  * @return Result of executing script
  */
-static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
+template<bool Profile = false>
+static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc, Uint64* instructions = nullptr)
 {
 	ProgPos curr = ProgPos::Start;
 	//--------------------------------------------------
 	//			helper macros for this function
 	//--------------------------------------------------
 	#define MACRO_FUNC_ARRAY(NAME, ...) + helper::FuncGroup<MACRO_FUNC_ID(NAME)>::FuncList{}
-	#define MACRO_FUNC_ARRAY_LOOP(POS) \
-		case (POS): \
+	#define MACRO_FUNC_ARRAY_CALL(POS, NEXT) \
 		{ \
+			if (Profile) ++*instructions; \
 			using currType = helper::GetType<func, POS>; \
 			const auto p = proc + (int)curr; \
 			curr += currType::offset; \
@@ -464,12 +491,36 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 				} \
 			} \
 			else \
-				continue; \
+				NEXT; \
 		}
 	//--------------------------------------------------
 
 	using func = decltype(MACRO_PROC_DEFINITION(MACRO_FUNC_ARRAY));
 
+#if SCRIPT_THREADED_DISPATCH
+
+	#define MACRO_FUNC_ARRAY_LABEL(HIGH, LOW) &&opLabel_##HIGH##LOW,
+	#define MACRO_FUNC_ARRAY_LOOP(HIGH, LOW) \
+		opLabel_##HIGH##LOW: \
+		MACRO_FUNC_ARRAY_CALL(0x##HIGH##LOW, goto *dispatch[proc[(int)curr++]])
+
+	static const void* const dispatch[256] =
+	{
+		MACRO_COPY_HEX_256(MACRO_FUNC_ARRAY_LABEL)
+	};
+
+	goto *dispatch[proc[(int)curr++]];
+	MACRO_COPY_HEX_256(MACRO_FUNC_ARRAY_LOOP)
+
+	#undef MACRO_FUNC_ARRAY_LOOP
+	#undef MACRO_FUNC_ARRAY_LABEL
+
+#else
+
+	#define MACRO_FUNC_ARRAY_LOOP(POS) \
+		case (POS): \
+		MACRO_FUNC_ARRAY_CALL(POS, continue)
+
 	while (true)
 	{
 		switch (proc[(int)curr++])
@@ -478,10 +529,14 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 		}
 	}
 
+	#undef MACRO_FUNC_ARRAY_LOOP
+
+#endif
+
 	//--------------------------------------------------
 	//			removing helper macros
 	//--------------------------------------------------
-	#undef MACRO_FUNC_ARRAY_LOOP
+	#undef MACRO_FUNC_ARRAY_CALL
 	#undef MACRO_FUNC_ARRAY
 	//--------------------------------------------------
 
@@ -496,6 +551,39 @@ static inline void scriptExe(ScriptWorkerBase& data, const Uint8* proc)
 	return;
 }
 
+/**
+ * Execute script and add its cost to profile data.
+ * @param proc array storing operation of script
+ * @param profile profile data of script
+ */
+static void scriptExeProfile(ScriptWorkerBase& data, const Uint8* proc, ScriptProfile* profile)
+{
+	Uint64 instructions = 0;
+	const auto start = std::chrono::steady_clock::now();
+	scriptExe<true>(data, proc, &instructions);
+	const auto end = std::chrono::steady_clock::now();
+
+	profile->calls += 1;
+	profile->instructions += instructions;
+	profile->nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+/**
+ * Execute script, with profiling if it is requested and script have profile data.
+ */
+template<bool Profile>
+static inline void scriptExeSelect(ScriptWorkerBase& data, const Uint8* proc, ScriptProfile* profile)
+{
+	if (Profile && profile)
+	{
+		scriptExeProfile(data, proc, profile);
+	}
+	else
+	{
+		scriptExe(data, proc);
+	}
+}
+
 
 ////////////////////////////////////////////////////////////
 //						Script class
@@ -505,6 +593,46 @@ void ScriptWorkerBlit::executeBlit(const Surface* src, Surface* dest, int x, int
 {
 	executeBlit(src, dest, x, y, shade, GraphSubset{ dest->getWidth(), dest->getHeight() } );
 }
+/**
+ * Run blit script with all its events for one pixel.
+ * @param src source pixel.
+ * @param dest current destination pixel.
+ * @return New destination pixel, zero if it should stay unchanged.
+ */
+template<bool Profile>
+inline int ScriptWorkerBlit::executePixel(int src, int dest)
+{
+	ScriptWorkerBlit::Output arg = { src, dest };
+	set(arg);
+	if (_events)
+	{
+		auto ptr = _events;
+		while (*ptr)
+		{
+			reset(arg);
+			scriptExeSelect<Profile>(*this, ptr->data(), ptr->getProfile());
+			++ptr;
+		}
+		++ptr;
+
+		reset(arg);
+		scriptExeSelect<Profile>(*this, _proc, _profile);
+
+		while (*ptr)
+		{
+			reset(arg);
+			scriptExeSelect<Profile>(*this, ptr->data(), ptr->getProfile());
+			++ptr;
+		}
+	}
+	else
+	{
+		scriptExeSelect<Profile>(*this, _proc, _profile);
+	}
+	get(arg);
+	return arg.getFirst();
+}
+
 /**
  * Blitting one surface to another using script.
  * @param src source surface.
@@ -521,60 +649,55 @@ void ScriptWorkerBlit::executeBlit(const Surface* src, Surface* dest, int x, int
 
 	if (_proc)
 	{
-		if (_events)
+		auto draw = [&](auto profile)
 		{
-			ShaderDrawFunc(
-				[&](Uint8& destStuff, const Uint8& srcStuff)
-				{
-					if (srcStuff)
+			constexpr bool Profile = decltype(profile)::value;
+			if (_destRead)
+			{
+				ShaderDrawFunc(
+					[&](Uint8& destStuff, const Uint8& srcStuff)
 					{
-						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
-						set(arg);
-						auto ptr = _events;
-						while (*ptr)
+						if (srcStuff)
 						{
-							reset(arg);
-							scriptExe(*this, ptr->data());
-							++ptr;
+							auto result = executePixel<Profile>(srcStuff, destStuff);
+							if (result) destStuff = result;
 						}
-						++ptr;
-
-						reset(arg);
-						scriptExe(*this, _proc);
-
-						while (*ptr)
+					},
+					destShader,
+					srcShader
+				);
+			}
+			else
+			{
+				// result depends only on source color, scripts are run once per color and reused for all other pixels
+				int colorResult[256];
+				bool colorDone[256] = { };
+				ShaderDrawFunc(
+					[&](Uint8& destStuff, const Uint8& srcStuff)
+					{
+						if (srcStuff)
 						{
-							reset(arg);
-							scriptExe(*this, ptr->data());
-							++ptr;
+							if (!colorDone[srcStuff])
+							{
+								colorResult[srcStuff] = executePixel<Profile>(srcStuff, 0);
+								colorDone[srcStuff] = true;
+							}
+							if (colorResult[srcStuff]) destStuff = colorResult[srcStuff];
 						}
-						++ptr;
+					},
+					destShader,
+					srcShader
+				);
+			}
+		};
 
-						get(arg);
-						if (arg.getFirst()) destStuff = arg.getFirst();
-					}
-				},
-				destShader,
-				srcShader
-			);
+		if (Options::oxceScriptProfiler)
+		{
+			draw(std::true_type{});
 		}
 		else
 		{
-			ShaderDrawFunc(
-				[&](Uint8& destStuff, const Uint8& srcStuff)
-				{
-					if (srcStuff)
-					{
-						ScriptWorkerBlit::Output arg = { srcStuff, destStuff };
-						set(arg);
-						scriptExe(*this, _proc);
-						get(arg);
-						if (arg.getFirst()) destStuff = arg.getFirst();
-					}
-				},
-				destShader,
-				srcShader
-			);
+			draw(std::false_type{});
 		}
 	}
 	else
@@ -583,15 +706,52 @@ void ScriptWorkerBlit::executeBlit(const Surface* src, Surface* dest, int x, int
 	}
 }
 
+/**
+ * Test if script or any of its events reference given register.
+ * @param reg register to check.
+ * @return True if any script could read or write this register.
+ */
+bool ScriptContainerEventsBase::isRegUsed(RegEnum reg) const
+{
+	if (_current.isRegUsed(reg))
+	{
+		return true;
+	}
+	if (auto ptr = _events)
+	{
+		// events before and after main script, each list ends with empty script
+		for (int i = 0; i < 2; ++i)
+		{
+			while (*ptr)
+			{
+				if (ptr->isRegUsed(reg))
+				{
+					return true;
+				}
+				++ptr;
+			}
+			++ptr;
+		}
+	}
+	return false;
+}
+
 /**
  * Execute script with two arguments.
  * @return Result value from script.
  */
-void ScriptWorkerBase::executeBase(const Uint8* proc)
+void ScriptWorkerBase::executeBase(const ScriptContainerBase& c)
 {
-	if (proc)
+	if (c)
 	{
-		scriptExe(*this, proc);
+		if (Options::oxceScriptProfiler)
+		{
+			scriptExeSelect<true>(*this, c.data(), c.getProfile());
+		}
+		else
+		{
+			scriptExe(*this, c.data());
+		}
 	}
 }
 
@@ -2902,6 +3062,21 @@ void ParserWriter::relese()
 			updateReserved<ProgPos>(pos, value);
 		}
 	);
+	// jump threading, label pointing to `goto` can jump directly to its final destination
+	refLabels.forEachPosition(
+		[&](auto pos, ProgPos value)
+		{
+			auto target = value;
+			for (int i = 0; i < 16 && container._proc[static_cast<size_t>(target)] == Proc_goto; ++i)
+			{
+				memcpy(&target, &container._proc[static_cast<size_t>(target) + 1], sizeof(ProgPos));
+			}
+			if (target != value)
+			{
+				updateReserved<ProgPos>(pos, target);
+			}
+		}
+	);
 
 	auto textTotalSize = 0u;
 	refTexts.forEachPosition(
@@ -3168,6 +3343,7 @@ bool ParserWriter::pushRegTry(const ScriptRefData& data, ArgEnum type)
 	type = ArgSpecAdd(type, ArgSpecReg);
 	if (data && ArgCompatible(type, data.type, 0) && data.getValue<RegEnum>() != RegInvalid)
 	{
+		container._regUsed.set(data.getValue<RegEnum>());
 		pushValue(data.getValue<RegEnum>());
 		return true;
 	}
@@ -3702,6 +3878,7 @@ bool ScriptParserBase::parseBase(ScriptContainerBase& destScript, const std::str
 				return false;
 			}
 			help.relese();
+			tempScript._profile = _shared->addProfile(_name, parentName);
 			destScript = std::move(tempScript);
 			return true;
 		}
@@ -4571,6 +4748,62 @@ void ScriptGlobal::endLoad()
 	_currFile = "After-load validation";
 }
 
+/**
+ * Add profile data for new script.
+ * @param name name of script type.
+ * @param parent name of object owning this script.
+ * @return Profile data with stable address.
+ */
+ScriptProfile* ScriptGlobal::addProfile(const std::string& name, const std::string& parent)
+{
+	_profiles.push_back(ScriptProfile{ name, parent, _currProfileMod });
+	return &_profiles.back();
+}
+
+/**
+ * Write collected profile data to log, grouped by mod and by script, and reset it.
+ */
+void ScriptGlobal::logProfile()
+{
+	auto logLine = [](const std::string& name, const ScriptProfile& p)
+	{
+		Log(LOG_INFO) << "    " << name << ": " << p.calls << " calls, " << p.instructions << " ops, " << std::fixed << std::setprecision(3) << p.nanoseconds / 1000000.0 << " ms";
+	};
+
+	std::vector<ScriptProfile*> used;
+	std::map<std::string, ScriptProfile> mods;
+	for (auto& p : _profiles)
+	{
+		if (p.calls)
+		{
+			used.push_back(&p);
+			auto& m = mods[p.mod];
+			m.calls += p.calls;
+			m.instructions += p.instructions;
+			m.nanoseconds += p.nanoseconds;
+		}
+	}
+	if (used.empty())
+	{
+		return;
+	}
+	std::sort(used.begin(), used.end(), [](const ScriptProfile* a, const ScriptProfile* b) { return a->nanoseconds > b->nanoseconds; });
+
+	Log(LOG_INFO) << "Script profile by mod:";
+	for (const auto& m : mods)
+	{
+		logLine(m.first.empty() ? "<engine>" : m.first, m.second);
+	}
+	Log(LOG_INFO) << "Script profile by script:";
+	for (auto* p : used)
+	{
+		logLine(p->mod + " " + p->name + " for '" + p->parent + "'", *p);
+		p->calls = 0;
+		p->instructions = 0;
+		p->nanoseconds = 0;
+	}
+}
+
 /**
  * Load global data from YAML.
  */
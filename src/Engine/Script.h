@@ -18,6 +18,8 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include <map>
+#include <deque>
+#include <bitset>
 #include <limits>
 #include <vector>
 #include <string>
@@ -385,13 +387,29 @@ struct TypeInfo
 //				containers definitions
 ////////////////////////////////////////////////////////////
 
+/**
+ * Execution statistics of one script, collected when script profiling is enabled.
+ */
+struct ScriptProfile
+{
+	std::string name;
+	std::string parent;
+	std::string mod;
+	Uint64 calls = 0;
+	Uint64 instructions = 0;
+	Uint64 nanoseconds = 0;
+};
+
 /**
  * Common base of script execution.
  */
 class ScriptContainerBase
 {
 	friend struct ParserWriter;
+	friend class ScriptParserBase;
 	std::vector<Uint8> _proc;
+	std::bitset<ScriptMaxReg> _regUsed;
+	ScriptProfile* _profile = nullptr;
 
 public:
 	/// Constructor.
@@ -420,6 +438,18 @@ public:
 	{
 		return *this ? _proc.data() : nullptr;
 	}
+
+	/// Test if script reference given register.
+	bool isRegUsed(RegEnum reg) const
+	{
+		return _regUsed.test(reg);
+	}
+
+	/// Get profile data of this script.
+	ScriptProfile* getProfile() const
+	{
+		return _profile;
+	}
 };
 
 /**
@@ -462,11 +492,19 @@ public:
 	{
 		return _current.data();
 	}
+	/// Get main script.
+	const ScriptContainerBase& current() const
+	{
+		return _current;
+	}
 	/// Get pointer to proc data.
 	const ScriptContainerBase* dataEvents() const
 	{
 		return _events;
 	}
+
+	/// Test if script or any of its events reference given register.
+	bool isRegUsed(RegEnum reg) const;
 };
 
 /**
@@ -693,6 +731,13 @@ class ScriptWorkerBase
 	}
 
 protected:
+	/// Get register used by output argument.
+	template<typename... Args>
+	static constexpr RegEnum regOutput(helper::TypeTag<ScriptOutputArgs<Args...>>, int i)
+	{
+		return static_cast<RegEnum>(offset<void, Args...>(i, 0));
+	}
+
 	/// Update values in script.
 	template<typename Output, typename... Args>
 	void updateBase(Args... args)
@@ -718,7 +763,7 @@ protected:
 	}
 
 	/// Call script.
-	void executeBase(const Uint8* proc);
+	void executeBase(const ScriptContainerBase& c);
 
 public:
 	/// Default constructor.
@@ -777,7 +822,7 @@ public:
 		static_assert(std::is_same<typename Parent::Output, Output>::value, "Incompatible script output type");
 
 		set(arg);
-		executeBase(c.data());
+		executeBase(c);
 		get(arg);
 	}
 
@@ -794,19 +839,19 @@ public:
 			while (*ptr)
 			{
 				reset(arg);
-				executeBase(ptr->data());
+				executeBase(*ptr);
 				++ptr;
 			}
 			++ptr;
 		}
 		reset(arg);
-		executeBase(c.data());
+		executeBase(c.current());
 		if (ptr)
 		{
 			while (*ptr)
 			{
 				reset(arg);
-				executeBase(ptr->data());
+				executeBase(*ptr);
 				++ptr;
 			}
 		}
@@ -822,17 +867,28 @@ class ScriptWorkerBlit : public ScriptWorkerBase
 	/// Current script set in worker.
 	const Uint8* _proc;
 	const ScriptContainerBase* _events;
+	/// Profile data of current script.
+	ScriptProfile* _profile;
+	/// Do current scripts read destination pixel.
+	bool _destRead;
+
+	/// Run scripts for one pixel.
+	template<bool Profile>
+	int executePixel(int src, int dest);
 
 public:
 	/// Type of output value from script.
 	using Output = ScriptOutputArgs<int&, int>;
 
 	/// Default constructor.
-	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr)
+	ScriptWorkerBlit() : ScriptWorkerBase(), _proc(nullptr), _events(nullptr), _profile(nullptr), _destRead(true)
 	{
 
 	}
 
+	/// Is any script set in worker.
+	bool hasScript() const { return _proc != nullptr; }
+
 	/// Update data from container script.
 	template<typename Parent, typename... Args>
 	void update(const ScriptContainer<Parent, Args...>& c, helper::Decay<Args>... args)
@@ -843,6 +899,8 @@ public:
 		{
 			_proc = c.data();
 			_events = nullptr;
+			_profile = c.getProfile();
+			_destRead = c.isRegUsed(regOutput(helper::TypeTag<Output>{}, 1));
 			updateBase<Output>(args...);
 		}
 	}
@@ -857,6 +915,8 @@ public:
 		{
 			_proc = c.data();
 			_events = c.dataEvents();
+			_profile = c.current().getProfile();
+			_destRead = c.isRegUsed(regOutput(helper::TypeTag<Output>{}, 1));
 			updateBase<Output>(args...);
 		}
 	}
@@ -871,6 +931,8 @@ public:
 	{
 		_proc = nullptr;
 		_events = nullptr;
+		_profile = nullptr;
+		_destRead = true;
 	}
 };
 
@@ -1688,6 +1750,8 @@ protected:
 
 private:
 	std::string _currFile;
+	std::string _currProfileMod;
+	std::deque<ScriptProfile> _profiles;
 	std::vector<std::vector<char>> _strings;
 	std::vector<std::vector<ScriptContainerBase>> _events;
 	std::map<std::string, ScriptParserBase*> _parserNames;
@@ -1773,6 +1837,13 @@ public:
 	/// Get current file that is loaded.
 	const std::string& getCurrentFile() const { return _currFile; }
 
+	/// Set name of mod that next scripts are loaded from.
+	void setProfileMod(const std::string& mod) { _currProfileMod = mod; }
+	/// Add profile data for new script.
+	ScriptProfile* addProfile(const std::string& name, const std::string& parent);
+	/// Write collected profile data to log and reset it.
+	void logProfile();
+
 	/// Initialize shared globals like types.
 	virtual void initParserGlobals(ScriptParserBase* parser) { }
 	/// Prepare for loading data.
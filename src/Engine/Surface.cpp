@@ -203,7 +203,7 @@ void Surface::CleanSdlSurface(SDL_Surface* surface)
  */
 void Surface::UniqueBufferDeleter::operator ()(Uint8* buffer)
 {
-	if (buffer)
+	if (buffer && !external)
 	{
 #ifdef _WIN32
 		_aligned_free(buffer);
@@ -351,6 +351,87 @@ void Surface::loadScr(const std::string& filename)
 	std::vector<char> buffer((std::istreambuf_iterator<char>(*(istream))), (std::istreambuf_iterator<char>()));
 	loadRaw(buffer);
 }
+/**
+ * Decodes the contents of a PNG image file into the surface
+ * with LodePNG. Leaves the surface empty if the file could not be decoded.
+ * @param rw Opened image file, not closed by this function.
+ * @param filename Filename of the image.
+ */
+void Surface::decodePng(SDL_RWops *rw, const std::string &filename)
+{
+	size_t size;
+	void *data = SDL_LoadFile_RW(rw, &size, SDL_FALSE);
+	if ((data != NULL) && (size > 8 + 12 + 12)) // minimal PNG file size: header and two empty chunks
+	{
+		std::vector<unsigned char> png;
+		png.resize(size);
+		memcpy(&png[0], data, size);
+
+		std::vector<unsigned char> image;
+		unsigned width, height;
+		lodepng::State state;
+		state.decoder.color_convert = 0;
+		unsigned error = lodepng::decode(image, width, height, state, png);
+		if (!error)
+		{
+			LodePNGColorMode *color = &state.info_png.color;
+			unsigned bpp = lodepng_get_bpp(color);
+			if (bpp == 8)
+			{
+				*this = Surface(width, height, 0, 0);
+				setPalette((SDL_Color*)color->palette, 0, color->palettesize);
+
+				ShaderDrawFunc(
+					[](Uint8& dest, unsigned char& src)
+					{
+						dest = src;
+					},
+					ShaderSurface(this),
+					ShaderSurface(SurfaceRaw<unsigned char>(image, width, height))
+				);
+				int transparent = 0;
+				for (int c = 0; c < _surface->format->palette->ncolors; ++c)
+				{
+					SDL_Color *palColor = _surface->format->palette->colors + c;
+					if (palColor->unused == 0)
+					{
+						transparent = c;
+						break;
+					}
+				}
+				FixTransparent(_surface, transparent);
+				if (transparent != 0)
+				{
+					Log(LOG_WARNING) << "Image " << filename << " (from lodepng) has incorrect transparent color index " << transparent << " (instead of 0).";
+				}
+			}
+		} else {
+			Log(LOG_ERROR) << "Image " << filename << " lodepng failed:" << lodepng_error_text(error);
+		}
+	}
+	if (data) { SDL_free(data); }
+}
+
+/**
+ * Loads the contents of a PNG image file into the surface
+ * using only LodePNG, without falling back to SDL_image.
+ * Unlike loadImage() this is safe to call outside the main thread.
+ * @param filename Filename of the image.
+ * @return True if the image was loaded.
+ */
+bool Surface::loadPng(const std::string &filename)
+{
+	_alignedBuffer = nullptr;
+	_surface = nullptr;
+
+	auto rw = FileMap::getRWops(filename);
+	if (!rw) { return false; }
+
+	decodePng(rw, filename);
+	SDL_RWclose(rw);
+	return _surface != nullptr;
+}
+
 /**
  * Loads the contents of an image file of a
  * known format into the surface.
@@ -369,57 +450,7 @@ void Surface::loadImage(const std::string &filename)
 	// Try loading with LodePNG first
 	if (CrossPlatform::compareExt(filename, "png"))
 	{
-		size_t size;
-		void *data = SDL_LoadFile_RW(rw, &size, SDL_FALSE);
-		if ((data != NULL) && (size > 8 + 12 + 12)) // minimal PNG file size: header and two empty chunks
-		{
-			std::vector<unsigned char> png;
-			png.resize(size);
-			memcpy(&png[0], data, size);
-
-			std::vector<unsigned char> image;
-			unsigned width, height;
-			lodepng::State state;
-			state.decoder.color_convert = 0;
-			unsigned error = lodepng::decode(image, width, height, state, png);
-			if (!error)
-			{
-				LodePNGColorMode *color = &state.info_png.color;
-				unsigned bpp = lodepng_get_bpp(color);
-				if (bpp == 8)
-				{
-					*this = Surface(width, height, 0, 0);
-					setPalette((SDL_Color*)color->palette, 0, color->palettesize);
-
-					ShaderDrawFunc(
-						[](Uint8& dest, unsigned char& src)
-						{
-							dest = src;
-						},
-						ShaderSurface(this),
-						ShaderSurface(SurfaceRaw<unsigned char>(image, width, height))
-					);
-					int transparent = 0;
-					for (int c = 0; c < _surface->format->palette->ncolors; ++c)
-					{
-						SDL_Color *palColor = _surface->format->palette->colors + c;
-						if (palColor->unused == 0)
-						{
-							transparent = c;
-							break;
-						}
-					}
-					FixTransparent(_surface, transparent);
-					if (transparent != 0)
-					{
-						Log(LOG_WARNING) << "Image " << filename << " (from lodepng) has incorrect transparent color index " << transparent << " (instead of 0).";
-					}
-				}
-			} else {
-				Log(LOG_ERROR) << "Image " << filename << " lodepng failed:" << lodepng_error_text(error);
-			}
-		}
-		if (data) { SDL_free(data); }
+		decodePng(rw, filename);
 	}
 	if (_surface)
 	{
@@ -1028,6 +1059,48 @@ void Surface::resize(int width, int height)
 	_pitch = _surface->pitch;
 }
 
+/**
+ * Replaces the pixel buffer, keeping size, palette and transparency.
+ * @param buffer New buffer, already holding the pixels.
+ */
+void Surface::replaceBuffer(UniqueBufferPtr buffer)
+{
+	auto surface = NewSdlSurface(buffer, 8, getWidth(), getHeight());
+
+	SDL_SetColorKey(surface.get(), SDL_SRCCOLORKEY, 0);
+	SDL_SetColors(surface.get(), getPalette(), 0, 256);
+
+	_surface = std::move(surface);
+	_alignedBuffer = std::move(buffer);
+	_pitch = _surface->pitch;
+}
+
+/**
+ * Moves the pixels to memory that is owned by someone else,
+ * that memory needs to outlive this surface.
+ * @param buffer Aligned memory with at least pitch * height bytes, already holding a copy of the pixels.
+ */
+void Surface::setExternalBuffer(Uint8 *buffer)
+{
+	replaceBuffer(UniqueBufferPtr(buffer, UniqueBufferDeleter{ true }));
+}
+
+/**
+ * Moves the pixels back from external memory to a buffer owned by this surface,
+ * needed before the surface is changed when other surfaces can share the same external memory.
+ */
+void Surface::setOwnBuffer()
+{
+	if (!hasExternalBuffer())
+	{
+		return;
+	}
+
+	auto buffer = NewAlignedBuffer(8, getWidth(), getHeight());
+	memcpy(buffer.get(), _alignedBuffer.get(), getPitch() * getHeight());
+	replaceBuffer(std::move(buffer));
+}
+
 /**
  * Changes the width of the surface.
  * @warning This is not a trivial setter!
@@ -46,6 +46,11 @@ class Surface
 public:
 	struct UniqueBufferDeleter
 	{
+		/// Buffer is owned by someone else, e.g. SurfaceAtlas.
+		bool external;
+
+		UniqueBufferDeleter() : external{ false } { }
+		explicit UniqueBufferDeleter(bool ext) : external{ ext } { }
 		void operator()(Uint8*);
 	};
 	struct UniqueSurfaceDeleter
@@ -95,6 +100,10 @@ protected:
 	void rawCopy(const std::vector<T> &bytes);
 	/// Resizes the surface.
 	void resize(int width, int height);
+	/// Replaces the pixel buffer with another one of the same size.
+	void replaceBuffer(UniqueBufferPtr buffer);
+	/// Decodes a PNG image with LodePNG.
+	void decodePng(SDL_RWops *rw, const std::string &filename);
 public:
 	/// Default empty surface.
 	Surface();
@@ -117,6 +126,16 @@ public:
 		return _alignedBuffer.get();
 	}
 
+	/// Checks if the pixels are stored in memory owned by someone else.
+	bool hasExternalBuffer() const
+	{
+		return _alignedBuffer && _alignedBuffer.get_deleter().external;
+	}
+	/// Moves the pixels to memory owned by someone else.
+	void setExternalBuffer(Uint8 *buffer);
+	/// Moves the pixels back to a buffer owned by this surface.
+	void setOwnBuffer();
+
 	/// Loads a raw pixel array.
 	void loadRaw(const std::vector<unsigned char> &bytes);
 	/// Loads a raw pixel array.
@@ -129,6 +148,8 @@ public:
 	void loadBdy(const std::string &filename);
 	/// Loads a general image file.
 	void loadImage(const std::string &filename);
+	/// Loads a PNG image file without SDL_image.
+	bool loadPng(const std::string &filename);
 	/// Clears the surface's contents with a specified colour.
 	void clear();
 	/// Offsets the surface's colors by a set amount.
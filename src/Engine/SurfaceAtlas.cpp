@@ -0,0 +1,146 @@
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "SurfaceAtlas.h"
+#include <string_view>
+#include <cstring>
+#include "SurfaceSet.h"
+
+namespace OpenXcom
+{
+
+namespace
+{
+
+/**
+ * Alignment of pixel data, same as used by Surface::NewAlignedBuffer.
+ */
+constexpr size_t SlotAlignment = 16;
+
+/**
+ * Hash of pixel data.
+ */
+size_t hashPixels(const Uint8 *data, size_t size)
+{
+	return std::hash<std::string_view>{}(std::string_view{ reinterpret_cast<const char*>(data), size });
+}
+
+} //namespace
+
+/**
+ * Creates an empty atlas, pages are allocated on demand.
+ */
+SurfaceAtlas::SurfaceAtlas() : _currentPage(nullptr), _pageUsed(0), _totalFrames(0), _sharedFrames(0), _totalBytes(0)
+{
+
+}
+
+/**
+ * Finds an already stored copy of pixels.
+ * @param hash Hash of the pixels.
+ * @param data Pixels to look for.
+ * @param size Size of pixels in bytes.
+ * @return Pointer to the stored copy or null.
+ */
+Uint8 *SurfaceAtlas::find(size_t hash, const Uint8 *data, size_t size) const
+{
+	auto range = _slots.equal_range(hash);
+	for (auto i = range.first; i != range.second; ++i)
+	{
+		if (i->second.size == size && memcmp(i->second.data, data, size) == 0)
+		{
+			return i->second.data;
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * Gets memory for new pixels, from the current page if they fit in it.
+ * @param size Size of pixels in bytes.
+ * @return Aligned memory.
+ */
+Uint8 *SurfaceAtlas::allocate(size_t size)
+{
+	if (size > PageSize / 4)
+	{
+		// big surfaces would waste too much of a page, give them their own
+		_pages.push_back(Surface::NewAlignedBuffer(8, (int)size, 1));
+		_totalBytes += size;
+		return _pages.back().get();
+	}
+
+	if (!_currentPage || _pageUsed + size > PageSize)
+	{
+		_pages.push_back(Surface::NewAlignedBuffer(8, (int)PageSize, 1));
+		_totalBytes += PageSize;
+		_currentPage = _pages.back().get();
+		_pageUsed = 0;
+	}
+
+	Uint8 *slot = _currentPage + _pageUsed;
+	_pageUsed += (size + SlotAlignment - 1) & ~(SlotAlignment - 1);
+	return slot;
+}
+
+/**
+ * Moves the pixels of a surface into the atlas, reusing
+ * an identical copy if one is already stored.
+ * Surfaces that already use external memory are left untouched.
+ * @param surface Surface to pack.
+ */
+void SurfaceAtlas::pack(Surface *surface)
+{
+	if (!surface || !*surface || surface->hasExternalBuffer())
+	{
+		return;
+	}
+
+	const Uint8 *data = surface->getBuffer();
+	const size_t size = (size_t)surface->getPitch() * surface->getHeight();
+	const size_t hash = hashPixels(data, size);
+
+	Uint8 *slot = find(hash, data, size);
+	if (slot)
+	{
+		++_sharedFrames;
+	}
+	else
+	{
+		slot = allocate(size);
+		memcpy(slot, data, size);
+		_slots.emplace(hash, Slot{ slot, size });
+	}
+	++_totalFrames;
+
+	surface->setExternalBuffer(slot);
+}
+
+/**
+ * Moves the pixels of all frames of a surface set into the atlas.
+ * @param set Surface set to pack.
+ */
+void SurfaceAtlas::pack(SurfaceSet *set)
+{
+	for (size_t i = 0; i < set->getTotalFrames(); ++i)
+	{
+		pack(set->getFrame((int)i));
+	}
+}
+
+}
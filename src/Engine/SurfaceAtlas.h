@@ -0,0 +1,78 @@
+#pragma once
+/*
+ * Copyright 2010-2016 OpenXcom Developers.
+ *
+ * This file is part of OpenXcom.
+ *
+ * OpenXcom is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * OpenXcom is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <vector>
+#include <unordered_map>
+#include <SDL.h>
+#include "Surface.h"
+
+namespace OpenXcom
+{
+
+class SurfaceSet;
+
+/**
+ * Shared pixel storage for frames of surface sets.
+ * Instead of every frame having its own allocation, frames are packed
+ * one after another in big pages and byte-identical frames
+ * (common when many mods ship the same sprites) are stored only once.
+ * Pages are freed only with the atlas, so it needs to outlive all surfaces using it.
+ */
+class SurfaceAtlas
+{
+private:
+	/// Size of one page of the atlas.
+	static constexpr size_t PageSize = 1024 * 1024;
+
+	struct Slot
+	{
+		Uint8 *data;
+		size_t size;
+	};
+
+	std::vector<Surface::UniqueBufferPtr> _pages;
+	Uint8 *_currentPage;
+	size_t _pageUsed;
+	std::unordered_multimap<size_t, Slot> _slots;
+	size_t _totalFrames, _sharedFrames, _totalBytes;
+
+	/// Finds an already stored copy of pixels.
+	Uint8 *find(size_t hash, const Uint8 *data, size_t size) const;
+	/// Gets memory for new pixels.
+	Uint8 *allocate(size_t size);
+public:
+	/// Creates an empty atlas.
+	SurfaceAtlas();
+	SurfaceAtlas(const SurfaceAtlas&) = delete;
+	SurfaceAtlas& operator=(const SurfaceAtlas&) = delete;
+
+	/// Moves the pixels of a surface into the atlas.
+	void pack(Surface *surface);
+	/// Moves the pixels of all frames of a surface set into the atlas.
+	void pack(SurfaceSet *set);
+
+	/// Gets the number of frames stored in the atlas.
+	size_t getTotalFrames() const { return _totalFrames; }
+	/// Gets the number of frames that reuse pixels of another frame.
+	size_t getSharedFrames() const { return _sharedFrames; }
+	/// Gets the memory used by all pages.
+	size_t getTotalBytes() const { return _totalBytes; }
+};
+
+}
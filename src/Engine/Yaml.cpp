@@ -18,6 +18,9 @@
  */
 
 #include "Yaml.h"
+#include <array>
+#include <atomic>
+#include <cstring>
 #include "../Engine/CrossPlatform.h"
 #include <string>
 #include <c4/format.hpp>
@@ -45,8 +48,12 @@ C4_NORETURN void YamlErrorHandler::on_error(const char* msg, size_t len, ryml::L
 {
 	throw Exception("Rapidyaml " + std::string{msg, len}); // This function must not return
 }
+/// Allocations made through the callbacks below, for benchmarks.
+static std::atomic<Uint64> s_allocationCount{ 0 }, s_allocationBytes{ 0 };
 static void* s_allocate(size_t len, void* /*hint*/, void* this_)
 {
+	s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+	s_allocationBytes.fetch_add(len, std::memory_order_relaxed);
 	return SDL_malloc(len);
 }
 static void s_free(void* mem, size_t len, void* this_)
@@ -64,6 +71,11 @@ void setGlobalErrorHandler()
 	ryml::set_callbacks(errh.callbacks());
 }
 
+AllocationStats getAllocationStats()
+{
+	return AllocationStats{ s_allocationCount.load(std::memory_order_relaxed), s_allocationBytes.load(std::memory_order_relaxed) };
+}
+
 
 C4_NORETURN static void RootReader_error(const char* msg, size_t len, ryml::Location loc, void* this_)
 {
@@ -257,15 +269,11 @@ ryml::ConstNodeRef YamlNodeReader::findChildNode(const ryml::csubstr& key) const
 	return ryml::ConstNodeRef(_node.m_tree, ryml::NONE);
 }
 
-std::vector<YamlNodeReader> YamlNodeReader::children() const
+YamlChildRange YamlNodeReader::children() const
 {
-	std::vector<YamlNodeReader> children;
 	if (_node.invalid())
-		return children;
-	children.reserve(_node.num_children());
-	for (const ryml::ConstNodeRef child : _node.cchildren())
-		children.emplace_back(child);
-	return children;
+		return YamlChildRange(_node.tree(), ryml::NONE);
+	return YamlChildRange(_node.tree(), _node.tree()->first_child(_node.id()));
 }
 
 bool YamlNodeReader::isValid() const
@@ -399,6 +407,20 @@ void YamlNodeReader::throwNodeError(const std::string& what) const
 }
 
 
+////////////////////////////////////////////////////////////
+//					YamlChildRange
+////////////////////////////////////////////////////////////
+
+
+size_t YamlChildRange::size() const
+{
+	size_t count = 0;
+	for (ryml::id_type i = _firstChild; i != ryml::NONE; i = _tree->next_sibling(i))
+		++count;
+	return count;
+}
+
+
 ////////////////////////////////////////////////////////////
 //					YamlRootNodeReader
 ////////////////////////////////////////////////////////////
@@ -406,11 +428,12 @@ void YamlNodeReader::throwNodeError(const std::string& what) const
 
 YamlRootNodeReader::YamlRootNodeReader(const std::string& fullFilePath, bool onlyInfoHeader, bool resolveReferences) : YamlNodeReader(), _tree(new ryml::Tree(callbacksForRootReader(this)))
 {
-	RawData data = onlyInfoHeader ? CrossPlatform::getYamlSaveHeaderRaw(fullFilePath) : CrossPlatform::readFileRaw(fullFilePath);
-	ryml::csubstr str = ryml::csubstr((char*)data.data(), data.size());
+	// keep the file contents and parse them in place, saves copying a whole save into the arena
+	_source = onlyInfoHeader ? CrossPlatform::getYamlSaveHeaderRaw(fullFilePath) : CrossPlatform::readFileRaw(fullFilePath);
+	ryml::csubstr str = ryml::csubstr((char*)_source.data(), _source.size());
 	if (onlyInfoHeader)
-		str = ryml::csubstr((char*)data.data(), str.find("\n---") + 1);
-	Parse(str, fullFilePath, true, resolveReferences);
+		str = ryml::csubstr((char*)_source.data(), str.find("\n---") + 1);
+	Parse(str, fullFilePath, true, resolveReferences, true);
 }
 
 YamlRootNodeReader::YamlRootNodeReader(const RawData& data, const std::string& fileNameForError, bool resolveReferences) : YamlNodeReader(), _tree(new ryml::Tree(callbacksForRootReader(this)))
@@ -423,7 +446,295 @@ YamlRootNodeReader::YamlRootNodeReader(const YamlString& yamlString, std::string
 	Parse(ryml::to_csubstr(yamlString.yaml), std::move(description), false, resolveReferences);
 }
 
-void YamlRootNodeReader::Parse(ryml::csubstr yaml, std::string fileNameForError, bool withNodeLocations, bool resoleReferences)
+namespace
+{
+
+/// Identifies the snapshot format, changes when its layout changes.
+const char SnapshotMagic[8] = { 'O', 'X', 'Y', 'A', 'M', 'L', '0', '2' };
+
+struct SnapshotHeader
+{
+	char magic[8];
+	Uint64 size, root;
+	Uint64 nodesSize, arenaSize;
+};
+
+/// Nodes in use are saved in tree order, so the links can be rebuilt from the number of children.
+struct SnapshotNode
+{
+	Uint32 type;
+	Uint32 children;
+	/// Which strings of the node are followed by a SnapshotString.
+	Uint32 strings;
+	Uint32 line, col;
+};
+
+/// Offset and length of a string in the arena.
+struct SnapshotString
+{
+	Uint32 offset, len;
+};
+
+const int SnapshotStringCount = 6;
+
+/// Ids are stored as 64 bit, NONE included.
+Uint64 saveId(ryml::id_type id)
+{
+	return id == ryml::NONE ? ~(Uint64)0 : (Uint64)id;
+}
+
+ryml::id_type loadId(Uint64 id)
+{
+	return id == ~(Uint64)0 ? ryml::NONE : (ryml::id_type)id;
+}
+
+/// Gets every string of a node, in the order they are saved.
+std::array<ryml::csubstr*, SnapshotStringCount> getStrings(ryml::NodeData& node)
+{
+	return { &node.m_key.tag, &node.m_key.scalar, &node.m_key.anchor, &node.m_val.tag, &node.m_val.scalar, &node.m_val.anchor };
+}
+
+/**
+ * Reads the nodes of a snapshot, checking everything as it goes, a damaged cache must not crash the game.
+ * @param snapshot Snapshot data.
+ * @param header Header of the snapshot.
+ * @param tree Tree to fill with the nodes, with room for all of them and the arena in place. Null to only check them.
+ * @param locations Filled with the line and column of every node, when restoring.
+ * @return True if all the nodes are valid.
+ */
+bool readSnapshotNodes(const Uint8* snapshot, const SnapshotHeader& header, ryml::Tree* tree, std::vector<Uint32>* locations)
+{
+	const Uint8* pos = snapshot + sizeof(header);
+	const Uint8* end = pos + header.nodesSize;
+	// nodes still waiting for children, and how many
+	std::vector<std::pair<ryml::id_type, Uint32>> parents;
+	for (Uint64 i = 0; i < header.size; ++i)
+	{
+		SnapshotNode saved;
+		if ((size_t)(end - pos) < sizeof(saved))
+		{
+			return false;
+		}
+		memcpy(&saved, pos, sizeof(saved));
+		pos += sizeof(saved);
+		if (parents.empty() != (i == 0) || saved.children > header.size - i - 1)
+		{
+			return false;
+		}
+
+		ryml::NodeData node = {};
+		node.m_type = (ryml::NodeType_e)saved.type;
+		for (int s = 0; s < SnapshotStringCount; ++s)
+		{
+			if (saved.strings & (1u << s))
+			{
+				SnapshotString str;
+				if ((size_t)(end - pos) < sizeof(str))
+				{
+					return false;
+				}
+				memcpy(&str, pos, sizeof(str));
+				pos += sizeof(str);
+				if (str.offset > header.arenaSize || str.len > header.arenaSize - str.offset)
+				{
+					return false;
+				}
+				if (tree)
+				{
+					*getStrings(node)[s] = ryml::csubstr(tree->m_arena.str + str.offset, str.len);
+				}
+			}
+		}
+		if (!tree)
+		{
+			if (!parents.empty() && --parents.back().second == 0)
+			{
+				parents.pop_back();
+			}
+			if (saved.children)
+			{
+				parents.emplace_back((ryml::id_type)i, saved.children);
+			}
+			continue;
+		}
+
+		const ryml::id_type id = (ryml::id_type)i;
+		node.m_parent = ryml::NONE;
+		node.m_first_child = ryml::NONE;
+		node.m_last_child = ryml::NONE;
+		node.m_next_sibling = ryml::NONE;
+		node.m_prev_sibling = ryml::NONE;
+		if (!parents.empty())
+		{
+			ryml::NodeData& parent = tree->m_buf[parents.back().first];
+			node.m_parent = parents.back().first;
+			node.m_prev_sibling = parent.m_last_child;
+			if (parent.m_last_child != ryml::NONE)
+				tree->m_buf[parent.m_last_child].m_next_sibling = id;
+			else
+				parent.m_first_child = id;
+			parent.m_last_child = id;
+			if (--parents.back().second == 0)
+			{
+				parents.pop_back();
+			}
+		}
+		if (saved.children)
+		{
+			parents.emplace_back(id, saved.children);
+		}
+		tree->m_buf[id] = node;
+		(*locations)[i * 2] = saved.line;
+		(*locations)[i * 2 + 1] = saved.col;
+	}
+	return pos == end && parents.empty();
+}
+
+}
+
+/**
+ * Checks a snapshot before restoring it, a damaged cache must not crash the game.
+ * @param snapshot Snapshot data.
+ * @param size Size of the data.
+ * @return True if the snapshot can be restored.
+ */
+bool YamlRootNodeReader::isValidSnapshot(const Uint8* snapshot, size_t size)
+{
+	SnapshotHeader header;
+	if (size < sizeof(header))
+	{
+		return false;
+	}
+	memcpy(&header, snapshot, sizeof(header));
+	if (memcmp(header.magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0 ||
+		header.size == 0 || header.nodesSize > size - sizeof(header) || header.arenaSize != size - sizeof(header) - header.nodesSize ||
+		header.size > header.nodesSize / sizeof(SnapshotNode) || (loadId(header.root) != ryml::NONE && header.root >= header.size))
+	{
+		return false;
+	}
+	return readSnapshotNodes(snapshot, header, nullptr, nullptr);
+}
+
+/**
+ * Restores a tree saved by saveSnapshot(), skipping the parsing
+ * and reference resolving. Only the links between nodes need rebuilding.
+ * @param snapshot Snapshot data, checked by isValidSnapshot().
+ * @param size Size of the data.
+ * @param fileNameForError File name shown in error messages.
+ */
+YamlRootNodeReader::YamlRootNodeReader(const Uint8* snapshot, size_t size, const std::string& fileNameForError) : YamlNodeReader(), _tree(new ryml::Tree(callbacksForRootReader(this)))
+{
+	SnapshotHeader header;
+	memcpy(&header, snapshot, sizeof(header));
+	const Uint8* arena = snapshot + sizeof(header) + header.nodesSize;
+
+	_fileName = fileNameForError;
+	{
+		// find only name of file, not whole path
+		size_t pos = _fileName.find_last_of('/');
+		if (pos != std::string::npos)
+			_fileName.erase(0, pos + 1);
+	}
+
+	const ryml::id_type count = (ryml::id_type)header.size;
+	_tree->reserve(count);
+	_tree->reserve_arena((size_t)header.arenaSize);
+	if (header.arenaSize)
+	{
+		memcpy(_tree->m_arena.str, arena, (size_t)header.arenaSize);
+	}
+	_tree->m_arena_pos = (size_t)header.arenaSize;
+	_snapshotLocations.resize((size_t)count * 2);
+	readSnapshotNodes(snapshot, header, _tree.get(), &_snapshotLocations);
+	_tree->m_size = count;
+
+	// the nodes past the saved ones, if any, make up the free list
+	_tree->m_free_head = ryml::NONE;
+	_tree->m_free_tail = ryml::NONE;
+	for (ryml::id_type i = count; i < _tree->m_cap; ++i)
+	{
+		_tree->m_buf[i].m_prev_sibling = i == count ? ryml::NONE : i - 1;
+		_tree->m_buf[i].m_next_sibling = i + 1 == _tree->m_cap ? ryml::NONE : i + 1;
+		if (i == count)
+			_tree->m_free_head = i;
+		_tree->m_free_tail = i;
+	}
+
+	_node = ryml::ConstNodeRef(_tree.get(), loadId(header.root));
+}
+
+/**
+ * Saves the nodes in use of the parsed tree, with the location of every node
+ * so error messages still point at the right line.
+ * @return Snapshot data, empty if the tree uses strings outside its arena.
+ */
+std::vector<Uint8> YamlRootNodeReader::saveSnapshot() const
+{
+	const ryml::Tree& tree = *_tree;
+	const ryml::csubstr arena = tree.arena();
+	if (!_parser || tree.m_tag_directives[0].handle.str != nullptr || arena.len > UINT32_MAX)
+	{
+		return {};
+	}
+
+	// number the nodes in use in tree order, the root stays first
+	std::vector<ryml::id_type> order;
+	std::vector<ryml::id_type> newIds(tree.m_cap, ryml::NONE);
+	order.reserve(tree.m_size);
+	std::vector<ryml::id_type> stack = { tree.root_id() };
+	while (!stack.empty())
+	{
+		ryml::id_type id = stack.back();
+		stack.pop_back();
+		newIds[id] = (ryml::id_type)order.size();
+		order.push_back(id);
+		for (ryml::id_type child = tree.last_child(id); child != ryml::NONE; child = tree.prev_sibling(child))
+		{
+			stack.push_back(child);
+		}
+	}
+
+	std::vector<Uint8> data(sizeof(SnapshotHeader));
+	data.reserve(sizeof(SnapshotHeader) + order.size() * (sizeof(SnapshotNode) + 2 * sizeof(SnapshotString)) + arena.len);
+	for (ryml::id_type id : order)
+	{
+		ryml::NodeData node = tree.m_buf[id];
+		ryml::Location loc = _parser->location(tree, id);
+		SnapshotNode saved = { (Uint32)node.m_type.type, (Uint32)tree.num_children(id), 0, (Uint32)loc.line, (Uint32)loc.col };
+		std::array<SnapshotString, SnapshotStringCount> strings;
+		int count = 0;
+		for (int s = 0; s < SnapshotStringCount; ++s)
+		{
+			const ryml::csubstr& str = *getStrings(node)[s];
+			if (str.str == nullptr)
+			{
+				continue;
+			}
+			if (str.str < arena.str || str.len > (size_t)(arena.str + arena.len - str.str))
+			{
+				return {};
+			}
+			saved.strings |= 1u << s;
+			strings[count++] = SnapshotString{ (Uint32)(str.str - arena.str), (Uint32)str.len };
+		}
+		const Uint8* savedBytes = (const Uint8*)&saved;
+		data.insert(data.end(), savedBytes, savedBytes + sizeof(saved));
+		const Uint8* stringBytes = (const Uint8*)strings.data();
+		data.insert(data.end(), stringBytes, stringBytes + count * sizeof(SnapshotString));
+	}
+
+	SnapshotHeader header;
+	memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+	header.size = order.size();
+	header.root = saveId(_node.id() == ryml::NONE ? ryml::NONE : newIds[_node.id()]);
+	header.nodesSize = data.size() - sizeof(header);
+	header.arenaSize = arena.len;
+	memcpy(data.data(), &header, sizeof(header));
+	data.insert(data.end(), arena.str, arena.str + arena.len);
+	return data;
+}
+
+void YamlRootNodeReader::Parse(ryml::csubstr yaml, std::string fileNameForError, bool withNodeLocations, bool resoleReferences, bool inPlace)
 {
 	if (yaml.len > 3 && yaml.first(3) == "\xEF\xBB\xBF") // skip UTF-8 BOM
 		yaml = yaml.offs(3, 0);
@@ -440,7 +751,10 @@ void YamlRootNodeReader::Parse(ryml::csubstr yaml, std::string fileNameForError,
 
 	_fileName = std::move(fileNameForError);
 	_tree->reserve(yaml.len / 16);
-	ryml::parse_in_arena(_parser.get(), ryml::to_csubstr(_fileName), yaml, _tree.get());
+	if (inPlace)
+		ryml::parse_in_place(_parser.get(), ryml::to_csubstr(_fileName), ryml::substr(const_cast<char*>(yaml.str), yaml.len), _tree.get()); // buffer owned by _source
+	else
+		ryml::parse_in_arena(_parser.get(), ryml::to_csubstr(_fileName), yaml, _tree.get());
 	if (resoleReferences)
 		_tree->resolve();
 	_node = _tree->crootref();
@@ -473,6 +787,10 @@ ryml::Location YamlRootNodeReader::getLocationInFile(const ryml::ConstNodeRef& n
 		loc.col += 1;
 		return loc;
 	}
+	else if (isSnapshot() && node.id() != ryml::NONE && (size_t)node.id() * 2 < _snapshotLocations.size())
+	{
+		return ryml::Location(ryml::to_csubstr(_fileName), _snapshotLocations[node.id() * 2] + 1, _snapshotLocations[node.id() * 2 + 1] + 1);
+	}
 	else
 		throw Exception("Parsed yaml without location data logging enabled");
 }
@@ -45,6 +45,7 @@
 #include <memory>
 #include <unordered_map>
 #include <optional>
+#include <iterator>
 #include <c4/format.hpp>
 #include <c4/type_name.hpp>
 #include "../Engine/CrossPlatform.h"
@@ -59,12 +60,23 @@ namespace OpenXcom
 namespace YAML
 {
 
+class YamlChildRange;
 class YamlRootNodeReader;
 class YamlRootNodeWriter;
 
 
 void setGlobalErrorHandler();
 
+/// Number and total size of allocations.
+struct AllocationStats
+{
+	Uint64 count;
+	Uint64 bytes;
+};
+
+/// Gets the allocations made by the YAML trees and parsers since startup.
+AllocationStats getAllocationStats();
+
 
 /// Basic string wrapper to differentiate from normal strings
 struct YamlString
@@ -166,8 +178,8 @@ public:
 	/// Returns the number of children of the current node. O(n) complexity, or O(1) if index is used.
 	size_t childrenCount() const;
 
-	/// Builds a vector of children and retuns it
-	std::vector<YamlNodeReader> children() const;
+	/// Returns a range over the children. Iterating it allocates nothing.
+	YamlChildRange children() const;
 
 	/// Returns whether the current node is valid. Just use the bool operator instead.
 	bool isValid() const;
@@ -211,6 +223,50 @@ public:
 };
 
 
+////////////////////////////////////////////////////////////
+//					YamlChildRange
+////////////////////////////////////////////////////////////
+
+
+/// Range over the children of a node, walking the sibling ids of the tree.
+class YamlChildRange
+{
+	const ryml::Tree* _tree;
+	ryml::id_type _firstChild;
+
+public:
+	class Iterator
+	{
+		const ryml::Tree* _tree;
+		ryml::id_type _id;
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = YamlNodeReader;
+		using difference_type = std::ptrdiff_t;
+		using pointer = void;
+		using reference = YamlNodeReader;
+
+		Iterator(const ryml::Tree* tree, ryml::id_type id) : _tree(tree), _id(id) { }
+
+		YamlNodeReader operator*() const { return YamlNodeReader(ryml::ConstNodeRef(_tree, _id)); }
+		Iterator& operator++() { _id = _tree->next_sibling(_id); return *this; }
+		Iterator operator++(int) { Iterator old = *this; ++*this; return old; }
+		bool operator==(const Iterator& other) const { return _id == other._id; }
+		bool operator!=(const Iterator& other) const { return _id != other._id; }
+	};
+
+	YamlChildRange(const ryml::Tree* tree, ryml::id_type firstChild) : _tree(tree), _firstChild(firstChild) { }
+
+	Iterator begin() const { return Iterator(_tree, _firstChild); }
+	Iterator end() const { return Iterator(_tree, ryml::NONE); }
+	/// Returns the number of children. O(n) complexity.
+	size_t size() const;
+	/// Returns true if there are no children.
+	bool empty() const { return _firstChild == ryml::NONE; }
+};
+
+
 ////////////////////////////////////////////////////////////
 //					YamlRootNodeReader
 ////////////////////////////////////////////////////////////
@@ -219,21 +275,34 @@ public:
 class YamlRootNodeReader : public YamlNodeReader
 {
 private:
+	/// File contents the tree points to when parsed in place.
+	RawData _source;
 	std::unique_ptr<ryml::EventHandlerTree> _eventHandler;
 	std::unique_ptr<ryml::Parser> _parser;
 	std::unique_ptr<ryml::Tree> _tree;
 	std::string _fileName;
+	/// Line and column of every node, when restored from a snapshot.
+	std::vector<Uint32> _snapshotLocations;
 
 	ryml::Location getLocationInFile(const ryml::ConstNodeRef& node) const;
 
-	void Parse(ryml::csubstr yaml, std::string fileName, bool withNodeLocations, bool resolveReferences);
+	void Parse(ryml::csubstr yaml, std::string fileName, bool withNodeLocations, bool resolveReferences, bool inPlace = false);
 
 public:
 	YamlRootNodeReader(const std::string& fullFilePath, bool onlyInfoHeader = false, bool resolveReferences = true);
 	YamlRootNodeReader(const RawData& data, const std::string& fileNameForError, bool resolveReferences = true);
 	YamlRootNodeReader(const YamlString& yamlString, std::string description, bool resolveReferences = true);
+	/// Restores a parsed file from a snapshot, check it with isValidSnapshot() first.
+	YamlRootNodeReader(const Uint8* snapshot, size_t size, const std::string& fileNameForError);
 	YamlRootNodeReader(YamlRootNodeReader&&) = delete;
 
+	/// Checks if a snapshot is complete and consistent.
+	static bool isValidSnapshot(const Uint8* snapshot, size_t size);
+	/// Saves the parsed tree as a snapshot, empty if it can't be saved.
+	std::vector<Uint8> saveSnapshot() const;
+	/// Was the tree restored from a snapshot?
+	bool isSnapshot() const { return !_snapshotLocations.empty(); }
+
 	/// Returns base class to avoid slicing
 	YamlNodeReader toBase() const;
 
@@ -233,7 +233,7 @@ std::string ConfirmDestinationState::checkStartingCondition()
 
 	// check required item(s)
 	auto requiredItems = rule->getRequiredItems();
-	if (!_crafts.front()->areRequiredItemsOnboard(requiredItems))
+	if (!_crafts.front()->areRequiredItemsOnboard(requiredItems, _game->getMod()))
 	{
 		std::ostringstream ss2;
 		int i2 = 0;
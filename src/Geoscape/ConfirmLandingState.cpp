@@ -216,7 +216,7 @@ std::string ConfirmLandingState::checkStartingCondition()
 			return tr("STR_STARTING_CONDITION_SOLDIER_TYPE"); // simple message without details/argument
 		}
 
-		if (!_craft->areRequiredItemsOnboard(rule->getRequiredItems()))
+		if (!_craft->areRequiredItemsOnboard(rule->getRequiredItems(), _game->getMod()))
 		{
 			return tr("STR_STARTING_CONDITION_ITEM"); // simple message without details/argument
 		}
@@ -224,7 +224,7 @@ std::string ConfirmLandingState::checkStartingCondition()
 		{
 			if (rule->getDestroyRequiredItems())
 			{
-				_craft->destroyRequiredItems(rule->getRequiredItems());
+				_craft->destroyRequiredItems(rule->getRequiredItems(), _game->getMod());
 			}
 		}
 	}
@@ -40,6 +40,7 @@
 #include "../Interface/Text.h"
 #include "../Interface/TextButton.h"
 #include "../Engine/Timer.h"
+#include "../Engine/Profiler.h"
 #include "../Savegame/GameTime.h"
 #include "../Savegame/SavedGame.h"
 #include "../Savegame/Base.h"
@@ -845,6 +846,7 @@ void GeoscapeState::timeDisplay()
  */
 void GeoscapeState::timeAdvance()
 {
+	ProfileScope profile("GeoscapeState::timeAdvance");
 	int timeSpan = 0;
 	if (_timeSpeed == _btn5Secs)
 	{
@@ -886,10 +888,24 @@ void GeoscapeState::timeAdvance()
 	}
 
 
+	int quietTicks = 0;
 	for (int i = 0; i < timeSpan && !_pause; ++i)
 	{
 		TimeTrigger trigger;
 		trigger = _game->getSavedGame()->getTime()->advance();
+		if (trigger == TIME_5SEC && quietTicks > 0)
+		{
+			// nothing can happen in this step, only landed UFOs count down
+			--quietTicks;
+			for (auto* ufo : *_game->getSavedGame()->getUfos())
+			{
+				if (ufo->getStatus() == Ufo::LANDED)
+				{
+					ufo->think();
+				}
+			}
+			continue;
+		}
 		switch (trigger)
 		{
 		case TIME_1MONTH:
@@ -910,6 +926,7 @@ void GeoscapeState::timeAdvance()
 		case TIME_5SEC:
 			time5Seconds();
 		}
+		quietTicks = _pause ? 0 : getQuietTicks();
 	}
 
 	_pause = !_dogfightsToBeStarted.empty() || _zoomInEffectTimer->isRunning() || _zoomOutEffectTimer->isRunning();
@@ -938,6 +955,67 @@ const std::vector<Craft*>* GeoscapeState::updateActiveCrafts()
 	return &_activeCrafts;
 }
 
+/**
+ * Gets how many of the following 5 second steps can be skipped, because
+ * time5Seconds() would not change anything in them except landed UFO timers.
+ * That is the case when nothing is flying, fighting or recharging,
+ * until the first landed UFO is due to lift off.
+ * Only valid right after time5Seconds() ran, other triggers are never skipped.
+ * @return Number of steps, 0 if the next one needs to be processed.
+ */
+int GeoscapeState::getQuietTicks() const
+{
+	if ((_timeSpeed == _btn5Secs || _timeSpeed == _btn1Min) && _game->getMod()->getHunterKillerFastRetarget())
+	{
+		return 0;
+	}
+	if (_game->getSavedGame()->getBases()->empty() || _game->getSavedGame()->getEnding() == END_LOSE)
+	{
+		return 0;
+	}
+	if (!_dogfights.empty() || !_dogfightsToBeStarted.empty())
+	{
+		return 0;
+	}
+
+	int quietTicks = INT_MAX;
+	for (const auto* ufo : *_game->getSavedGame()->getUfos())
+	{
+		switch (ufo->getStatus())
+		{
+		case Ufo::LANDED:
+			// the step that reaches zero lifts the UFO off
+			quietTicks = std::min(quietTicks, (int)(ufo->getSecondsRemaining() / 5) - 1);
+			break;
+		case Ufo::CRASHED:
+			if (!ufo->getDetected() || ufo->getSecondsRemaining() == 0)
+			{
+				return 0;
+			}
+			break;
+		case Ufo::IGNORE_ME:
+			break;
+		default:
+			return 0;
+		}
+	}
+	for (const auto* xbase : *_game->getSavedGame()->getBases())
+	{
+		for (const auto* xcraft : *xbase->getCrafts())
+		{
+			if (xcraft->isDestroyed() || !xcraft->isStationary())
+			{
+				return 0;
+			}
+			if (xcraft->getShield() < xcraft->getCraftStats().shieldCapacity && xcraft->getCraftStats().shieldRechargeInGeoscape != 0)
+			{
+				return 0;
+			}
+		}
+	}
+	return std::max(quietTicks, 0);
+}
+
 /**
  * Takes care of any game logic that has to
  * run every game second, like craft movement.
@@ -1872,6 +1950,16 @@ bool GeoscapeState::processMissionSite(MissionSite *site)
 	return removeSite;
 }
 
+/**
+ * Radar of a base or an active craft, gathered once per detection pass.
+ */
+struct UfoDetectionSource
+{
+	Base *base;
+	Craft *craft;
+	BaseRadars radars;
+};
+
 /**
  * Takes care of any game logic that has to
  * run every game half hour, like UFO detection.
@@ -1989,6 +2077,9 @@ void GeoscapeState::time30Minutes()
 	std::map<OpenXcom::Region*, int> hiddenUfoRegions;
 	std::map<OpenXcom::Country*, int> hiddenUfoCountries;
 
+	std::vector<UfoDetectionSource> detectionSources;
+	prepareUfoDetection(activeCrafts, detectionSources);
+
 	// Handle UFO detection and give aliens points
 	for (auto ufo : *_game->getSavedGame()->getUfos())
 	{
@@ -2032,7 +2123,7 @@ void GeoscapeState::time30Minutes()
 
 			// detection ufo state
 
-			ufoDetection(ufo, activeCrafts);
+			ufoDetection(ufo, detectionSources);
 
 			// accumulate hidden ufos
 
@@ -2198,11 +2289,34 @@ void GeoscapeState::time30Minutes()
 	);
 }
 
+/**
+ * Gathers the radars of all bases and active crafts, so every UFO
+ * can be tested against them without walking the base facilities
+ * again for each UFO.
+ * @param activeCrafts List of active crafts.
+ * @param sources List of detection sources to fill, bases first.
+ */
+void GeoscapeState::prepareUfoDetection(const std::vector<Craft*>* activeCrafts, std::vector<UfoDetectionSource> &sources) const
+{
+	sources.clear();
+	sources.reserve(_game->getSavedGame()->getBases()->size() + activeCrafts->size());
+	for (auto* base : *_game->getSavedGame()->getBases())
+	{
+		sources.push_back(UfoDetectionSource{ base, nullptr, BaseRadars() });
+		base->getRadars(sources.back().radars);
+	}
+	for (auto* craft : *activeCrafts)
+	{
+		sources.push_back(UfoDetectionSource{ nullptr, craft, BaseRadars() });
+	}
+}
+
 /**
  * Logic responsible for detecting ufo and its tracking.
  * @param ufo
+ * @param sources Bases and crafts that can detect it, from prepareUfoDetection().
  */
-void GeoscapeState::ufoDetection(Ufo* ufo, const std::vector<Craft*>* activeCrafts)
+void GeoscapeState::ufoDetection(Ufo* ufo, const std::vector<UfoDetectionSource> &sources)
 {
 	auto maskTest = [](UfoDetection value, UfoDetection mask)
 	{
@@ -2217,14 +2331,18 @@ void GeoscapeState::ufoDetection(Ufo* ufo, const std::vector<Craft*>* activeCraf
 	auto alreadyTracked = ufo->getDetected();
 	auto save = _game->getSavedGame();
 
-	for (auto* base : *_game->getSavedGame()->getBases())
+	for (const auto& source : sources)
 	{
-		detected = maskBitOr(detected, base->detect(ufo, save, alreadyTracked));
-	}
-
-	for (auto* craft : *activeCrafts)
-	{
-		detected = maskBitOr(detected, craft->detect(ufo, save, alreadyTracked));
+		if (source.base)
+		{
+			int distance = XcomDistance(source.base->getDistance(ufo));
+			detected = maskBitOr(detected, source.base->detect(ufo, save, alreadyTracked, source.radars, distance));
+		}
+		else
+		{
+			int distance = XcomDistance(source.craft->getDistance(ufo));
+			detected = maskBitOr(detected, source.craft->detect(ufo, save, alreadyTracked, distance));
+		}
 	}
 
 	if (!alreadyTracked)
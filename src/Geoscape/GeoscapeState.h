@@ -38,6 +38,7 @@ class Ufo;
 class MissionSite;
 class Base;
 class RuleMissionScript;
+struct UfoDetectionSource;
 
 /**
  * Geoscape screen which shows an overview of
@@ -74,6 +75,8 @@ private:
 
 	/// Update list of active crafts.
 	const std::vector<Craft*>* updateActiveCrafts();
+	/// Gets how many of the next 5 second steps would do nothing but count down.
+	int getQuietTicks() const;
 
 	void cbxRegionChange(Action *action);
 	void cbxZoneChange(Action *action);
@@ -104,7 +107,9 @@ public:
 	void baseHunting();
 	/// Trigger whenever 30 minutes pass.
 	void time30Minutes();
-	void ufoDetection(Ufo* ufo, const std::vector<Craft*>* activeCrafts);
+	/// Gathers the radars of all bases and active crafts for a detection pass.
+	void prepareUfoDetection(const std::vector<Craft*>* activeCrafts, std::vector<UfoDetectionSource> &sources) const;
+	void ufoDetection(Ufo* ufo, const std::vector<UfoDetectionSource> &sources);
 	/// Trigger whenever 1 hour passes.
 	void time1Hour();
 	/// Trigger whenever 1 day passes.
@@ -53,6 +53,7 @@
 #include "../Mod/Texture.h"
 #include "../Interface/Cursor.h"
 #include "../Engine/Screen.h"
+#include "../Engine/Profiler.h"
 
 namespace OpenXcom
 {
@@ -285,21 +286,67 @@ struct CreateShadow
 	{
 		return Globe::OCEAN_SHADING && dest >= Globe::OCEAN_COLOR && dest < Globe::OCEAN_COLOR + 32;
 	}
+};
+
+///shadow map value of pixels outside the globe
+const Uint8 ShadowNone = 0xFF;
+///shadow map value of pixels the shadow pass does not touch
+const Uint8 ShadowKeep = 0xFE;
+
+struct CacheShadow
+{
+	static inline void func(Uint8& shadow, const Cord& earth, const Cord& sun, const Sint16& noise)
+	{
+		shadow = earth.z ? CreateShadow::getShadowValue(earth, sun, noise) : ShadowNone;
+	}
+};
+
+///scale of the quantized sphere depth stored in the globe surface cache
+const double EarthDepthScale = 65535.0;
+
+struct CacheShadowWithSurfaceCache
+{
+	static inline void func(Uint8& shadow, const helper::Offset& offset, const Uint16& depth, const Cord& sun, const Sint16& noise, const double& invRadius)
+	{
+		Cord earth;
+		if (depth)
+		{
+			earth.x = (offset.x + .5) * invRadius;
+			earth.y = (offset.y + .5) * invRadius;
+			earth.z = depth * (1. / EarthDepthScale);
+		}
+		CacheShadow::func(shadow, earth, sun, noise);
+	}
+};
+
+struct CacheShadowWithoutCache
+{
+	static inline void func(Uint8& shadow, const helper::Offset& offset, const Cord& sun, const Sint16& noise, const int& radius)
+	{
+		Cord earth = static_data.circle_norm(0., 0., radius, offset.x, offset.y);
+		CacheShadow::func(shadow, earth, sun, noise);
+	}
+};
 
-	static inline void func(Uint8& dest, const Cord& earth, const Cord& sun, const Sint16& noise)
+struct ApplyShadow
+{
+	static inline void func(Uint8& dest, const Uint8& shadow)
 	{
-		if (dest && earth.z)
+		if (shadow == ShadowKeep)
+		{
+			return;
+		}
+		if (dest && shadow != ShadowNone)
 		{
-			const Uint8 shadow = getShadowValue(earth, sun, noise);
 			//this pixel is ocean
-			if (isOcean(dest))
+			if (CreateShadow::isOcean(dest))
 			{
-				dest = getOceanShadow(shadow);
+				dest = CreateShadow::getOceanShadow(shadow);
 			}
 			//this pixel is land
 			else
 			{
-				dest = getLandShadow(dest, shadow);
+				dest = CreateShadow::getLandShadow(dest, shadow);
 			}
 		}
 		else
@@ -309,13 +356,12 @@ struct CreateShadow
 	}
 };
 
-struct CreateShadowWithoutCache
+///worker thread computing one band of rows of the shadow map
+struct ShadowWorker
 {
-	static inline void func(Uint8& dest, const helper::Offset& offset, const Cord& sun, const Sint16& noise, const int& radius)
-	{
-		Cord earth = static_data.circle_norm(0., 0., radius, offset.x, offset.y);
-		CreateShadow::func(dest, earth, sun, noise);
-	}
+	Globe *globe;
+	int band;
+	Uint32 job;
 };
 
 }//namespace
@@ -332,7 +378,9 @@ struct CreateShadowWithoutCache
  * @param y Y position in pixels.
  */
 Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y) : InteractiveSurface(width, height, x, y), _cenX(cenX), _cenY(cenY), _rotLon(0.0), _rotLat(0.0), _hoverLon(0.0), _hoverLat(0.0), _craftLon(0.0), _craftLat(0.0), _craftRange(0.0), _game(game), _hover(false), _craft(false), _blink(-1),
-																					_isMouseScrolling(false), _isMouseScrolled(false), _xBeforeMouseScrolling(0), _yBeforeMouseScrolling(0), _lonBeforeMouseScrolling(0.0), _latBeforeMouseScrolling(0.0), _mouseScrollingStartTime(0), _totalMouseMoveX(0), _totalMouseMoveY(0), _mouseMovedOverThreshold(false)
+																					_isMouseScrolling(false), _isMouseScrolled(false), _xBeforeMouseScrolling(0), _yBeforeMouseScrolling(0), _lonBeforeMouseScrolling(0.0), _latBeforeMouseScrolling(0.0), _mouseScrollingStartTime(0), _totalMouseMoveX(0), _totalMouseMoveY(0), _mouseMovedOverThreshold(false),
+																					_shadowCenX(0), _shadowCenY(0), _shadowZoom(0), _shadowThreads(), _shadowWorkers(0), _shadowBands(0), _shadowPending(0), _shadowJob(0), _shadowQuit(false),
+																					_shadowMutex(SDL_CreateMutex()), _shadowStart(SDL_CreateCond()), _shadowDone(SDL_CreateCond())
 {
 	_rules = game->getMod()->getGlobe();
 	_texture = new SurfaceSet(*_game->getMod()->getSurfaceSet("TEXTURE.DAT"));
@@ -358,6 +406,7 @@ Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y
 	setupRadii(width, height);
 	setZoom(_zoom);
 
+	buildPolygonIndex();
 	cachePolygons();
 }
 
@@ -366,6 +415,18 @@ Globe::Globe(Game* game, int cenX, int cenY, int width, int height, int x, int y
  */
 Globe::~Globe()
 {
+	SDL_mutexP(_shadowMutex);
+	_shadowQuit = true;
+	SDL_CondBroadcast(_shadowStart);
+	SDL_mutexV(_shadowMutex);
+	for (int i = 0; i < _shadowWorkers; ++i)
+	{
+		SDL_WaitThread(_shadowThreads[i], 0);
+	}
+	SDL_DestroyCond(_shadowDone);
+	SDL_DestroyCond(_shadowStart);
+	SDL_DestroyMutex(_shadowMutex);
+
 	delete _blinkTimer;
 	delete _rotTimer;
 	delete _countries;
@@ -373,11 +434,6 @@ Globe::~Globe()
 	delete _texture;
 	delete _radars;
 	delete _clipper;
-
-	for (auto* polygon : _cacheLand)
-	{
-		delete polygon;
-	}
 }
 
 /**
@@ -452,46 +508,188 @@ bool Globe::pointBack(double lon, double lat) const
 	return c < 0.0;
 }
 
+/**
+ * Builds a lat/lon grid over the land polygons, so a point lookup only
+ * has to test the few polygons whose bounding cap touches its cell.
+ * The point test projects each polygon around the point itself, so
+ * a polygon can never match a point outside its bounding cap.
+ */
+void Globe::buildPolygonIndex()
+{
+	const double epsilon = 1e-6;
+	const double cellLon = 2 * M_PI / POLYGON_GRID_COLS;
+	std::vector<std::vector<Uint32> > cells(POLYGON_GRID_COLS * POLYGON_GRID_ROWS);
+
+	_polygonBounds.clear();
+	_polygonPoints.clear();
+	_pointX.clear();
+	_pointY.clear();
+	_pointZ.clear();
+	for (auto* polygon : *_rules->getPolygons())
+	{
+		PolygonBounds bounds;
+		bounds.polygon = polygon;
+		bounds.first = _polygonPoints.size();
+		bounds.points = polygon->getPoints();
+
+		Cord sum;
+		for (int j = 0; j < bounds.points; ++j)
+		{
+			double lat = polygon->getLatitude(j);
+			double lon = polygon->getLongitude(j);
+			Cord unit = Cord(CordPolar(lon, lat));
+			_polygonPoints.push_back(PolygonPoint{ cos(lat), sin(lat), cos(lon), sin(lon) });
+			_pointX.push_back(unit.x);
+			_pointY.push_back(unit.y);
+			_pointZ.push_back(unit.z);
+			sum += unit;
+		}
+
+		// bounding cap around the mean direction of the points
+		double radius = M_PI;
+		if (sum.norm() > epsilon)
+		{
+			sum /= sum.norm();
+			double minDot = 1.0;
+			for (int j = 0; j < bounds.points; ++j)
+			{
+				Cord p = Cord(CordPolar(polygon->getLongitude(j), polygon->getLatitude(j)));
+				minDot = std::min(minDot, p.x * sum.x + p.y * sum.y + p.z * sum.z);
+			}
+			radius = acos(Clamp(minDot, -1.0, 1.0)) + epsilon;
+		}
+		bounds.center = sum;
+		bounds.cosRadius = radius < M_PI_2 ? cos(radius) : -2.0;
+
+		Uint32 id = _polygonBounds.size();
+		_polygonBounds.push_back(bounds);
+
+		if (radius >= M_PI_2)
+		{
+			// too big to bound, check it everywhere
+			for (auto& cell : cells)
+			{
+				cell.push_back(id);
+			}
+			continue;
+		}
+
+		CordPolar center = CordPolar(sum);
+		int rowMin = getPolygonCell(0.0, center.lat - radius) / POLYGON_GRID_COLS;
+		int rowMax = getPolygonCell(0.0, center.lat + radius) / POLYGON_GRID_COLS;
+		int colMin = 0;
+		int colMax = POLYGON_GRID_COLS - 1;
+		if (center.lat + radius < M_PI_2 && center.lat - radius > -M_PI_2)
+		{
+			double lon = center.lon < 0.0 ? center.lon + 2 * M_PI : center.lon;
+			double delta = asin(std::min(1.0, sin(radius) / cos(center.lat))) + epsilon;
+			colMin = (int)floor((lon - delta) / cellLon);
+			colMax = (int)floor((lon + delta) / cellLon);
+			if (colMax - colMin >= POLYGON_GRID_COLS)
+			{
+				colMin = 0;
+				colMax = POLYGON_GRID_COLS - 1;
+			}
+		}
+		for (int row = rowMin; row <= rowMax; ++row)
+		{
+			for (int col = colMin; col <= colMax; ++col)
+			{
+				int wrapped = (col % POLYGON_GRID_COLS + POLYGON_GRID_COLS) % POLYGON_GRID_COLS;
+				cells[row * POLYGON_GRID_COLS + wrapped].push_back(id);
+			}
+		}
+	}
+
+	_polygonCellStart.clear();
+	_polygonCellItems.clear();
+	_polygonCellStart.reserve(cells.size() + 1);
+	for (const auto& cell : cells)
+	{
+		_polygonCellStart.push_back(_polygonCellItems.size());
+		_polygonCellItems.insert(_polygonCellItems.end(), cell.begin(), cell.end());
+	}
+	_polygonCellStart.push_back(_polygonCellItems.size());
+
+	_screenX.resize(_pointX.size());
+	_screenY.resize(_pointX.size());
+	_screenZ.resize(_pointX.size());
+	_cacheLand.reserve(_polygonBounds.size());
+}
+
+/**
+ * Gets the polygon grid cell containing a polar point.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Index of the cell.
+ */
+int Globe::getPolygonCell(double lon, double lat)
+{
+	lon = fmod(lon, 2 * M_PI);
+	if (lon < 0.0)
+	{
+		lon += 2 * M_PI;
+	}
+	int col = Clamp((int)(lon * POLYGON_GRID_COLS / (2 * M_PI)), 0, POLYGON_GRID_COLS - 1);
+	int row = Clamp((int)((lat + M_PI_2) * POLYGON_GRID_ROWS / M_PI), 0, POLYGON_GRID_ROWS - 1);
+	return row * POLYGON_GRID_COLS + col;
+}
+
+/**
+ * Gets the first land polygon containing a polar point.
+ * Only the polygons listed in the point's grid cell are tested,
+ * in the same order as the globe ruleset.
+ * @param lon Longitude of the point.
+ * @param lat Latitude of the point.
+ * @return Pointer to the polygon, or NULL if there is none.
+ */
 Polygon* Globe::getPolygonFromLonLat(double lon, double lat) const
 {
 	const double zDiscard=0.75f;
 	double coslat = cos(lat);
 	double sinlat = sin(lat);
+	double coslon = cos(lon);
+	double sinlon = sin(lon);
+	Cord point = Cord(sinlon * coslat, sinlat, coslon * coslat);
 
-	for (auto* polygon : *_rules->getPolygons())
+	int cell = getPolygonCell(lon, lat);
+	for (Uint32 i = _polygonCellStart[cell]; i < _polygonCellStart[cell + 1]; ++i)
 	{
-		double x, y, z, x2, y2;
-		double clat, clon;
-		z = 0;
-		for (int j = 0; j < polygon->getPoints(); ++j)
+		const PolygonBounds &bounds = _polygonBounds[_polygonCellItems[i]];
+		if (bounds.points == 0 || point.x * bounds.center.x + point.y * bounds.center.y + point.z * bounds.center.z < bounds.cosRadius)
+		{
+			continue;
+		}
+		const PolygonPoint *points = &_polygonPoints[bounds.first];
+
+		double x, y, x2, y2;
+		double z = 0;
+		for (int j = 0; j < bounds.points; ++j)
 		{
-			z = coslat * cos(polygon->getLatitude(j)) * cos(polygon->getLongitude(j) - lon) + sinlat * sin(polygon->getLatitude(j));
+			const PolygonPoint &p = points[j];
+			z = coslat * p.cosLat * (p.cosLon * coslon + p.sinLon * sinlon) + sinlat * p.sinLat;
 			if (z<zDiscard) break; //discarded
 		}
 		if (z<zDiscard) continue; //discarded
 
 		bool odd = false;
 
-		clat = polygon->getLatitude(0); //initial point
-		clon = polygon->getLongitude(0);
-		x = cos(clat) * sin(clon - lon);
-		y = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
+		x = points[0].cosLat * (points[0].sinLon * coslon - points[0].cosLon * sinlon); //initial point
+		y = coslat * points[0].sinLat - sinlat * points[0].cosLat * (points[0].cosLon * coslon + points[0].sinLon * sinlon);
 
-		for (int j = 0; j < polygon->getPoints(); ++j)
+		for (int j = 0; j < bounds.points; ++j)
 		{
-			int k = (j + 1) % polygon->getPoints(); //index of next point in poly
-			clat = polygon->getLatitude(k);
-			clon = polygon->getLongitude(k);
+			const PolygonPoint &p = points[(j + 1) % bounds.points]; //next point in poly
 
-			x2 = cos(clat) * sin(clon - lon);
-			y2 = coslat * sin(clat) - sinlat * cos(clat) * cos(clon - lon);
+			x2 = p.cosLat * (p.sinLon * coslon - p.cosLon * sinlon);
+			y2 = coslat * p.sinLat - sinlat * p.cosLat * (p.cosLon * coslon + p.sinLon * sinlon);
 			if ( ((y>0)!=(y2>0)) && (0 < (x2-x)*(0-y)/(y2-y)+x) )
 				odd = !odd;
 			x = x2;
 			y = y2;
 
 		}
-		if (odd) return polygon;
+		if (odd) return bounds.polygon;
 	}
 	return NULL;
 }
@@ -852,36 +1050,40 @@ std::vector<Target*> Globe::getTargets(int x, int y, bool craft, Craft *currentC
  * Takes care of pre-calculating all the polygons currently visible
  * on the globe and caching them so they only need to be recalculated
  * when the globe is actually moved.
+ * All points are projected in one pass over the precomputed unit
+ * vectors into buffers that are reused between calls.
  */
 void Globe::cachePolygons()
 {
-	cache(_rules->getPolygons(), &_cacheLand);
-}
+	// Orthographic projection, as the dot products of each point with the view axes
+	const double cosCenLat = cos(_cenLat), sinCenLat = sin(_cenLat);
+	const double cosCenLon = cos(_cenLon), sinCenLon = sin(_cenLon);
+	const Cord axisX = Cord(cosCenLon, 0.0, -sinCenLon);
+	const Cord axisY = Cord(-sinCenLat * sinCenLon, cosCenLat, -sinCenLat * cosCenLon);
+	const Cord axisZ = Cord(cosCenLat * sinCenLon, sinCenLat, cosCenLat * cosCenLon);
 
-/**
- * Caches a set of polygons.
- * @param polygons Pointer to list of polygons.
- * @param cache Pointer to cache.
- */
-void Globe::cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache)
-{
-	// Clear existing cache
-	for (auto* polygon : *cache)
+	const size_t size = _pointX.size();
+	const double *px = _pointX.data(), *py = _pointY.data(), *pz = _pointZ.data();
+	Sint16 *sx = _screenX.data(), *sy = _screenY.data();
+	double *sz = _screenZ.data();
+	for (size_t i = 0; i < size; ++i)
 	{
-		delete polygon;
+		sx[i] = _cenX + (Sint16)floor(_radius * (px[i] * axisX.x + pz[i] * axisX.z));
+		sy[i] = _cenY + (Sint16)floor(_radius * (px[i] * axisY.x + py[i] * axisY.y + pz[i] * axisY.z));
+		sz[i] = px[i] * axisZ.x + py[i] * axisZ.y + pz[i] * axisZ.z;
 	}
-	cache->clear();
 
-	// Pre-calculate values to cache
-	for (auto* polygon : *polygons)
+	_cacheLand.clear();
+	for (Uint32 i = 0; i < _polygonBounds.size(); ++i)
 	{
+		const PolygonBounds &bounds = _polygonBounds[i];
+
 		// Is quad on the back face?
 		double closest = 0.0;
-		double z;
 		double furthest = 0.0;
-		for (int j = 0; j < polygon->getPoints(); ++j)
+		for (int j = 0; j < bounds.points; ++j)
 		{
-			z = cos(_cenLat) * cos(polygon->getLatitude(j)) * cos(polygon->getLongitude(j) - _cenLon) + sin(_cenLat) * sin(polygon->getLatitude(j));
+			double z = sz[bounds.first + j];
 			if (z > closest)
 				closest = z;
 			else if (z < furthest)
@@ -890,18 +1092,7 @@ void Globe::cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache)
 		if (-furthest > closest)
 			continue;
 
-		Polygon* p = new Polygon(*polygon);
-
-		// Convert coordinates
-		for (int j = 0; j < p->getPoints(); ++j)
-		{
-			Sint16 x, y;
-			polarToCart(p->getLongitude(j), p->getLatitude(j), &x, &y);
-			p->setX(j, x);
-			p->setY(j, y);
-		}
-
-		cache->push_back(p);
+		_cacheLand.push_back(i);
 	}
 }
 
@@ -960,6 +1151,7 @@ void Globe::rotate()
  */
 void Globe::draw()
 {
+	ProfileScope profile("Globe::draw");
 	if (_redraw)
 	{
 		cachePolygons();
@@ -995,19 +1187,12 @@ void Globe::drawOcean()
  */
 void Globe::drawLand()
 {
-	Sint16 x[4], y[4];
-
-	for (auto* polygon : _cacheLand)
+	for (Uint32 i : _cacheLand)
 	{
-		// Convert coordinates
-		for (int j = 0; j < polygon->getPoints(); ++j)
-		{
-			x[j] = polygon->getX(j);
-			y[j] = polygon->getY(j);
-		}
+		const PolygonBounds &bounds = _polygonBounds[i];
 
 		// Apply textures according to zoom and shade
-		drawTexturedPolygon(x, y, polygon->getPoints(), _texture->getFrame(polygon->getTexture() + _zoomTexture), 0, 0);
+		drawTexturedPolygon(&_screenX[bounds.first], &_screenY[bounds.first], bounds.points, _texture->getFrame(bounds.polygon->getTexture() + _zoomTexture), 0, 0);
 	}
 }
 
@@ -1067,28 +1252,147 @@ Cord Globe::getSunDirection(double lon, double lat) const
 }
 
 
-void Globe::drawShadow()
+/**
+ * Computes the shadow map for a band of rows.
+ * @param sun Direction of the sun.
+ * @param begin First row of the band.
+ * @param end Row past the end of the band.
+ */
+void Globe::cacheShadowBand(const Cord &sun, int begin, int end)
 {
+	ShaderMove<Uint8> shadow = ShaderMove<Uint8>(SurfaceRaw<Uint8>(_shadowMap, getWidth(), getHeight()));
+	ShaderRepeat<Sint16> noise = ShaderRepeat<Sint16>(SurfaceRaw<Sint16>(static_data.random_noise, static_data.random_surf_size, static_data.random_surf_size));
+
+	shadow.setDomain(GraphSubset(std::make_pair(0, (int)getWidth()), std::make_pair(begin, end)));
+
 	if (Options::globeSurfaceCache)
 	{
-		ShaderMove<Cord> earth = ShaderMove<Cord>(SurfaceRaw<Cord>(_earthData[_zoom], getWidth(), getHeight()));
-		ShaderRepeat<Sint16> noise = ShaderRepeat<Sint16>(SurfaceRaw<Sint16>(static_data.random_noise, static_data.random_surf_size, static_data.random_surf_size));
+		ShaderMove<const Uint16> depth = ShaderMove<const Uint16>(SurfaceRaw<const Uint16>(_earthData[_zoom], getWidth(), getHeight()));
 
-		earth.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
+		depth.setMove(_cenX-getWidth()/2, _cenY-getHeight()/2);
 
-		lock();
-		ShaderDraw<CreateShadow>(ShaderSurface(this), earth, ShaderScalar(getSunDirection(_cenLon, _cenLat)), noise);
-		unlock();
+		ShaderDraw<CacheShadowWithSurfaceCache>(shadow, helper::Offset(_cenX, _cenY), depth, ShaderScalar(sun), noise, ShaderScalar(1. / _zoomRadius[_zoom]));
 	}
 	else
 	{
-		ShaderRepeat<Sint16> noise = ShaderRepeat<Sint16>(SurfaceRaw<Sint16>(static_data.random_noise, static_data.random_surf_size, static_data.random_surf_size));
+		ShaderDraw<CacheShadowWithoutCache>(shadow, helper::Offset(_cenX, _cenY), ShaderScalar(sun), noise, ShaderScalar(_zoomRadius[_zoom]));
+	}
+}
 
-		lock();
-		ShaderDraw<CreateShadowWithoutCache>(ShaderSurface(this), helper::Offset(_cenX, _cenY), ShaderScalar(getSunDirection(_cenLon, _cenLat)), noise, ShaderScalar(_zoomRadius[_zoom]));
-		unlock();
+/**
+ * Thread entry point of a shadow map worker.
+ * @param data Pointer to the ShadowWorker, owned by the thread.
+ * @return Always 0.
+ */
+int Globe::cacheShadowThread(void *data)
+{
+	ShadowWorker *worker = (ShadowWorker*)data;
+	worker->globe->runShadowWorker(worker->band, worker->job);
+	delete worker;
+	return 0;
+}
+
+/**
+ * Waits for drawShadow to start a new shadow map and computes
+ * one band of it, until the globe is destroyed.
+ * @param band Index of the band computed by this worker.
+ * @param done Last shadow map started before the worker, not computed by it.
+ */
+void Globe::runShadowWorker(int band, Uint32 done)
+{
+	SDL_mutexP(_shadowMutex);
+	while (true)
+	{
+		while (_shadowJob == done && !_shadowQuit)
+		{
+			SDL_CondWait(_shadowStart, _shadowMutex);
+		}
+		if (_shadowQuit)
+		{
+			break;
+		}
+		done = _shadowJob;
+		if (band < _shadowBands)
+		{
+			int bands = _shadowBands;
+			SDL_mutexV(_shadowMutex);
+			cacheShadowBand(_shadowSun, getHeight() * band / bands, getHeight() * (band + 1) / bands);
+			SDL_mutexP(_shadowMutex);
+			if (--_shadowPending == 0)
+			{
+				SDL_CondSignal(_shadowDone);
+			}
+		}
 	}
+	SDL_mutexV(_shadowMutex);
+}
+
+/**
+ * Renders the day/night shadow over the globe.
+ * The shadow of each pixel is kept in a shadow map, recomputed in
+ * bands of rows on worker threads only when the globe moves or the
+ * sun moves enough to shift the terminator by a gradient step.
+ */
+void Globe::drawShadow()
+{
+	const Cord sun = getSunDirection(_cenLon, _cenLat);
+	const size_t size = (size_t)getWidth() * getHeight();
+
+	Cord diff = sun;
+	diff -= _shadowSun;
+	bool valid = _shadowMap.size() == size && _shadowCenX == _cenX && _shadowCenY == _cenY && _shadowZoom == _zoom && diff.norm() < SHADOW_SUN_STEP;
+	if (!valid)
+	{
+		_shadowMap.assign(size, ShadowKeep);
+		_shadowSun = sun;
+		_shadowCenX = _cenX;
+		_shadowCenY = _cenY;
+		_shadowZoom = _zoom;
+
+		if (Options::globeSurfaceCache)
+		{
+			cacheEarthData(_zoom);
+		}
 
+		int bands = Clamp(getHeight() / SHADOW_BAND_MIN_ROWS, 1, SHADOW_THREADS);
+		// workers are started once and then reused for every recompute
+		while (_shadowWorkers < bands - 1 && _shadowMutex && _shadowStart && _shadowDone)
+		{
+			ShadowWorker *worker = new ShadowWorker{ this, _shadowWorkers + 1, _shadowJob };
+			SDL_Thread *thread = SDL_CreateThread(cacheShadowThread, (void*)worker);
+			if (!thread)
+			{
+				delete worker;
+				break;
+			}
+			_shadowThreads[_shadowWorkers++] = thread;
+		}
+		bands = std::min(bands, _shadowWorkers + 1);
+
+		if (bands > 1)
+		{
+			SDL_mutexP(_shadowMutex);
+			_shadowBands = bands;
+			_shadowPending = bands - 1;
+			++_shadowJob;
+			SDL_CondBroadcast(_shadowStart);
+			SDL_mutexV(_shadowMutex);
+		}
+		cacheShadowBand(sun, 0, getHeight() / bands);
+		if (bands > 1)
+		{
+			SDL_mutexP(_shadowMutex);
+			while (_shadowPending > 0)
+			{
+				SDL_CondWait(_shadowDone, _shadowMutex);
+			}
+			SDL_mutexV(_shadowMutex);
+		}
+	}
+
+	lock();
+	ShaderDraw<ApplyShadow>(ShaderSurface(this), ShaderSurface(SurfaceRaw<const Uint8>(_shadowMap, getWidth(), getHeight())));
+	unlock();
 }
 
 
@@ -2114,25 +2418,36 @@ void Globe::setupRadii(int width, int height)
 	_radius = _zoomRadius[_zoom];
 	_radiusStep = (_zoomRadius[DOGFIGHT_ZOOM] - _zoomRadius[0]) / 10.0;
 
-	if (Options::globeSurfaceCache)
+	// filled on first use by cacheEarthData
+	_earthData.clear();
+	_earthData.resize(_zoomRadius.size());
+	_shadowMap.clear();
+}
+
+/**
+ * Fills the globe surface cache of a zoom level, if it's not already.
+ * Only the depth of the sphere normal is kept, quantized to 16 bits;
+ * the other two components follow from the pixel position.
+ * @param zoom Zoom level.
+ */
+void Globe::cacheEarthData(size_t zoom)
+{
+	std::vector<Uint16> &data = _earthData[zoom];
+	if (!data.empty())
 	{
-		_earthData.resize(_zoomRadius.size());
-		//filling normal field for each radius
+		return;
+	}
 
-		for (size_t r = 0; r<_zoomRadius.size(); ++r)
+	const int width = getWidth();
+	const int height = getHeight();
+	data.resize(width * height);
+	for (int j=0; j<height; ++j)
+		for (int i=0; i<width; ++i)
 		{
-			_earthData[r].resize(width * height);
-			for (int j=0; j<height; ++j)
-				for (int i=0; i<width; ++i)
-				{
-					_earthData[r][width*j + i] = static_data.circle_norm(width/2, height/2, _zoomRadius[r], i+.5, j+.5);
-				}
+			double z = static_data.circle_norm(width/2, height/2, _zoomRadius[zoom], i+.5, j+.5).z;
+			// keep pixels inside the globe non-zero
+			data[width*j + i] = z > 0. ? (Uint16)Clamp((int)lround(z * EarthDepthScale), 1, 65535) : 0;
 		}
-	}
-	else
-	{
-		_earthData.clear();
-	}
 }
 
 /**
@@ -19,6 +19,7 @@
  */
 #include <vector>
 #include <list>
+#include <SDL_thread.h>
 #include "../Engine/InteractiveSurface.h"
 #include "../Engine/FastLineClip.h"
 #include "Cord.h"
@@ -52,6 +53,27 @@ private:
 	static const int CITY_MARKER = 8;
 	static const double ROTATE_LONGITUDE;
 	static const double ROTATE_LATITUDE;
+	static const int POLYGON_GRID_COLS = 180;
+	static const int POLYGON_GRID_ROWS = 90;
+	static const int SHADOW_THREADS = 4;
+	static const int SHADOW_BAND_MIN_ROWS = 64;
+	/// Sun movement that shifts the terminator by less than one shade gradient step.
+	static constexpr double SHADOW_SUN_STEP = 1.0 / 250.0;
+
+	/// Precomputed trigonometry of one polygon point.
+	struct PolygonPoint
+	{
+		double cosLat, sinLat, cosLon, sinLon;
+	};
+	/// Bounding cap of one polygon, used to reject lookups quickly.
+	struct PolygonBounds
+	{
+		Polygon *polygon;
+		Cord center;
+		double cosRadius;
+		size_t first;
+		int points;
+	};
 
 	RuleGlobe *_rules;
 	Sint16 _cenX, _cenY;
@@ -64,13 +86,24 @@ private:
 	bool _hover, _craft;
 	int _blink;
 	Timer *_blinkTimer, *_rotTimer;
-	std::list<Polygon*> _cacheLand;
+	///indexes of the visible polygons in _polygonBounds
+	std::vector<Uint32> _cacheLand;
 	FastLineClip *_clipper;
 	double _radius, _radiusStep;
-	///normal of each pixel in earth globe per zoom level
-	std::vector<std::vector<Cord> > _earthData;
+	///quantized depth of the sphere normal of each pixel per zoom level, filled on first use
+	std::vector<std::vector<Uint16> > _earthData;
 	///list of dimension of earth on screen per zoom level
 	std::vector<double> _zoomRadius;
+	///bounding caps and point data of every land polygon
+	std::vector<PolygonBounds> _polygonBounds;
+	std::vector<PolygonPoint> _polygonPoints;
+	///unit vectors of every polygon point, one array per axis
+	std::vector<double> _pointX, _pointY, _pointZ;
+	///screen position and depth of every polygon point, refreshed by cachePolygons
+	std::vector<Sint16> _screenX, _screenY;
+	std::vector<double> _screenZ;
+	///lat/lon grid of candidate polygons, stored as offsets into _polygonCellItems
+	std::vector<Uint32> _polygonCellStart, _polygonCellItems;
 
 	bool _isMouseScrolling, _isMouseScrolled;
 	int _xBeforeMouseScrolling, _yBeforeMouseScrolling;
@@ -78,19 +111,41 @@ private:
 	Uint32 _mouseScrollingStartTime;
 	int _totalMouseMoveX, _totalMouseMoveY;
 	bool _mouseMovedOverThreshold;
+	///shadow value of each pixel, reused while the globe and sun stay put
+	std::vector<Uint8> _shadowMap;
+	Cord _shadowSun;
+	Sint16 _shadowCenX, _shadowCenY;
+	size_t _shadowZoom;
+	///worker threads computing the shadow map bands after the first, kept for the life of the globe
+	SDL_Thread *_shadowThreads[SHADOW_THREADS - 1];
+	int _shadowWorkers, _shadowBands, _shadowPending;
+	Uint32 _shadowJob;
+	bool _shadowQuit;
+	SDL_mutex *_shadowMutex;
+	SDL_cond *_shadowStart, *_shadowDone;
 
 	/// Sets the globe zoom factor.
 	void setZoom(size_t zoom);
 	/// Checks if a point is behind the globe.
 	bool pointBack(double lon, double lat) const;
+	/// Builds the spatial index used by getPolygonFromLonLat.
+	void buildPolygonIndex();
+	/// Gets the grid cell of a polar point.
+	static int getPolygonCell(double lon, double lat);
 	/// Get polygon pointer
 	Polygon* getPolygonFromLonLat(double lon, double lat) const;
 	/// Checks if a target is near a point.
 	bool targetNear(Target* target, int x, int y) const;
-	/// Caches a set of polygons.
-	void cache(std::list<Polygon*> *polygons, std::list<Polygon*> *cache);
 	/// Get position of sun relative to given position in polar cords and date.
 	Cord getSunDirection(double lon, double lat) const;
+	/// Fills the globe surface cache of a zoom level.
+	void cacheEarthData(size_t zoom);
+	/// Computes a band of rows of the shadow map.
+	void cacheShadowBand(const Cord &sun, int begin, int end);
+	/// Thread entry point of a shadow map worker.
+	static int cacheShadowThread(void *data);
+	/// Computes shadow map bands whenever drawShadow asks for them.
+	void runShadowWorker(int band, Uint32 done);
 	/// Draw globe range circle.
 	void drawGlobeCircle(double lat, double lon, double radius, int segments, int frac = 1);
 	/// Special "transparent" line.
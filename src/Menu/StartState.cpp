@@ -30,11 +30,14 @@
 #include "../Engine/Font.h"
 #include "../Engine/Timer.h"
 #include "../Engine/CrossPlatform.h"
+#include "../Engine/Profiler.h"
+#include "../Engine/Yaml.h"
 #include "../Interface/FpsCounter.h"
 #include "../Interface/Cursor.h"
 #include "../Interface/Text.h"
 #include "MainMenuState.h"
 #include "CutsceneState.h"
+#include "../Savegame/SavedGame.h"
 #include <SDL_mixer.h>
 #include <SDL_thread.h>
 
@@ -305,13 +308,19 @@ int StartState::load(void *game_ptr)
 	Game *game = (Game*)game_ptr;
 	try
 	{
+		ProfilePhase phase("StartState::load");
 		Log(LOG_INFO) << "Loading data...";
 		Options::updateMods();
 		game->loadMods();
 		Log(LOG_INFO) << "Data loaded successfully.";
 		Log(LOG_INFO) << "Loading language...";
-		game->loadLanguages();
+		{
+			ProfilePhase languagePhase("Game::loadLanguages");
+			game->loadLanguages();
+		}
 		Log(LOG_INFO) << "Language loaded successfully.";
+		phase.end();
+		Profiler::logPhases("Startup phases");
 		loading = LOADING_SUCCESSFUL;
 	}
 	catch (std::exception &e)
@@ -324,4 +333,69 @@ int StartState::load(void *game_ptr)
 	return 0;
 }
 
+/**
+ * Loads the game resources several times in a row, logging
+ * the phase report of each run. The first run is a cold start,
+ * the others are warm starts with the files in the OS cache.
+ * @param game Pointer to the core game.
+ * @param runs Number of times to load.
+ */
+void StartState::benchmark(Game *game, int runs)
+{
+	for (int i = 0; i < runs; ++i)
+	{
+		Uint64 start = Profiler::now();
+		load((void*)game);
+		if (loading == LOADING_FAILED)
+		{
+			Log(LOG_ERROR) << "Startup benchmark aborted, loading failed.";
+			return;
+		}
+		Log(LOG_INFO) << "Startup benchmark run " << i + 1 << "/" << runs << " (" << (i == 0 ? "cold" : "warm") << "): "
+			<< (Profiler::now() - start) / 1000 << " ms, peak memory " << CrossPlatform::getPeakMemory() / (1024 * 1024) << " MB";
+	}
+}
+
+/**
+ * Loads the game resources, then loads a saved game several
+ * times in a row, logging the time and YAML allocations of each run.
+ * @param game Pointer to the core game.
+ * @param filename Name of the save file.
+ * @param runs Number of times to load the save.
+ */
+void StartState::benchmarkLoad(Game *game, const std::string &filename, int runs)
+{
+	if (filename.empty())
+	{
+		Log(LOG_ERROR) << "Save loading benchmark needs a save, given by -load.";
+		return;
+	}
+	load((void*)game);
+	if (loading == LOADING_FAILED)
+	{
+		Log(LOG_ERROR) << "Save loading benchmark aborted, loading failed.";
+		return;
+	}
+	for (int i = 0; i < runs; ++i)
+	{
+		SavedGame save;
+		YAML::AllocationStats before = YAML::getAllocationStats();
+		Uint64 start = Profiler::now();
+		try
+		{
+			save.load(filename, game->getMod(), game->getLanguage());
+		}
+		catch (std::exception &e)
+		{
+			Log(LOG_ERROR) << "Save loading benchmark aborted: " << e.what();
+			return;
+		}
+		Uint64 time = Profiler::now() - start;
+		YAML::AllocationStats after = YAML::getAllocationStats();
+		Log(LOG_INFO) << "Save loading benchmark run " << i + 1 << "/" << runs << ": "
+			<< time / 1000 << " ms, " << after.count - before.count << " YAML allocations ("
+			<< (after.bytes - before.bytes) / 1024 << " KB), peak memory " << CrossPlatform::getPeakMemory() / (1024 * 1024) << " MB";
+	}
+}
+
 }
@@ -66,6 +66,10 @@ public:
 	void addLine(const std::string &str);
 	/// Loads the game resources.
 	static int load(void *game_ptr);
+	/// Times loading the game resources without a display.
+	static void benchmark(Game *game, int runs);
+	/// Times loading a saved game without a display.
+	static void benchmarkLoad(Game *game, const std::string &filename, int runs);
 };
 
 }
@@ -400,6 +400,16 @@ std::string Armor::getSpriteInventory() const
 	return _spriteInv;
 }
 
+/**
+ * Gets the names of the inventory sprite of units that aren't soldiers,
+ * in the order they are looked up. Soldiers use Soldier::getSpriteInventoryNames().
+ * @return The inventory sprite names.
+ */
+std::vector<std::string> Armor::getSpriteInventoryNames() const
+{
+	return { _spriteInv, _spriteInv + ".SPK", _spriteInv + "M0.SPK" };
+}
+
 /**
  * Gets the front armor level.
  * @return The front armor level.
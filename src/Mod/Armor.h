@@ -202,6 +202,8 @@ public:
 	std::string getSpriteSheet() const;
 	/// Gets the unit's inventory sprite.
 	std::string getSpriteInventory() const;
+	/// Gets the names of the inventory sprites to try for units that aren't soldiers, in order.
+	std::vector<std::string> getSpriteInventoryNames() const;
 	/// Gets the front armor level.
 	int getFrontArmor() const;
 	/// Gets the left side armor level.
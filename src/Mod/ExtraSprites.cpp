@@ -22,6 +22,8 @@
 #include "../Engine/Surface.h"
 #include "../Engine/SurfaceSet.h"
 #include "../Engine/FileMap.h"
+#include "../Engine/ImagePrefetcher.h"
+#include "../Engine/AssetCache.h"
 #include "../Engine/Logger.h"
 #include "../Engine/Exception.h"
 #include "../Engine/Unicode.h"
@@ -168,12 +170,91 @@ bool ExtraSprites::isImageFile(const std::string &filename)
 	return false;
 }
 
+/**
+ * Gets the image files in a folder, in the order they are added to a surface set.
+ * @param folder Folder name, ending with slash.
+ * @return Names of the files, without the folder.
+ */
+std::vector<std::string> ExtraSprites::getFolderImages(const std::string &folder)
+{
+	std::vector<std::string> contents;
+	for (const auto& f: FileMap::getVFolderContents(folder))
+	{
+		if (isImageFile(f))
+		{
+			contents.push_back(f);
+		}
+	}
+	std::sort(contents.begin(), contents.end(), Unicode::naturalCompare);
+	return contents;
+}
+
+/**
+ * Gets all image files this sprite would load.
+ * @return Filenames of the images.
+ */
+std::vector<std::string> ExtraSprites::getImageFiles() const
+{
+	std::vector<std::string> files;
+	for (const auto& pair : _sprites)
+	{
+		const auto& fileName = pair.second;
+		if (fileName[fileName.length() - 1] == '/')
+		{
+			for (const auto& name : getFolderImages(fileName))
+			{
+				files.push_back(fileName + name);
+			}
+		}
+		else
+		{
+			files.push_back(fileName);
+		}
+	}
+	return files;
+}
+
+/**
+ * Loads an image file into a surface, using the already decoded copy if there is one.
+ * @param surface Surface to load into.
+ * @param filename Filename of the image.
+ * @param prefetcher Background loader, can be null.
+ * @param cache Decoded images from earlier runs, can be null.
+ */
+void ExtraSprites::loadImage(Surface *surface, const std::string &filename, ImagePrefetcher *prefetcher, AssetCache *cache)
+{
+	Uint64 key = 0;
+	if (cache)
+	{
+		key = AssetCache::getFileKey(filename);
+		if (cache->loadSurface(key, surface))
+		{
+			Log(LOG_VERBOSE) << "Using cached image: " << filename;
+			return;
+		}
+	}
+	if (prefetcher && prefetcher->take(filename, surface))
+	{
+		Log(LOG_VERBOSE) << "Using prefetched image: " << filename;
+	}
+	else
+	{
+		surface->loadImage(filename);
+	}
+	if (cache)
+	{
+		cache->storeSurface(key, surface);
+	}
+}
+
 /**
  * Loads the external sprite into a new or existing surface.
  * @param surface Existing surface.
+ * @param prefetcher Background loader with images decoded ahead of time, can be null.
+ * @param cache Decoded images from earlier runs, can be null.
  * @return New surface.
  */
-Surface *ExtraSprites::loadSurface(Surface *surface)
+Surface *ExtraSprites::loadSurface(Surface *surface, ImagePrefetcher *prefetcher, AssetCache *cache)
 {
 	if (!_singleImage)
 		return surface;
@@ -189,16 +270,18 @@ Surface *ExtraSprites::loadSurface(Surface *surface)
 		delete surface;
 	}
 	surface = new Surface(_width, _height);
-	surface->loadImage(_sprites.begin()->second);
+	loadImage(surface, _sprites.begin()->second, prefetcher, cache);
 	return surface;
 }
 
 /**
  * Loads the external sprite into a new or existing surface set.
  * @param set Existing surface set.
+ * @param prefetcher Background loader with images decoded ahead of time, can be null.
+ * @param cache Decoded images from earlier runs, can be null.
  * @return New surface set.
  */
-SurfaceSet *ExtraSprites::loadSurfaceSet(SurfaceSet *set)
+SurfaceSet *ExtraSprites::loadSurfaceSet(SurfaceSet *set, ImagePrefetcher *prefetcher, AssetCache *cache)
 {
 	if (_singleImage)
 		return set;
@@ -232,16 +315,11 @@ SurfaceSet *ExtraSprites::loadSurfaceSet(SurfaceSet *set)
 		{
 			Log(LOG_VERBOSE) << "Loading surface set from folder: " << fileName << " starting at frame: " << startFrame;
 			int offset = startFrame;
-			std::vector<std::string> contents;
-			for (const auto& f: FileMap::getVFolderContents(fileName)) { contents.push_back(f); }
-			std::sort(contents.begin(), contents.end(), Unicode::naturalCompare);
-			for (const auto& name : contents)
+			for (const auto& name : getFolderImages(fileName))
 			{
-				if (!isImageFile(name))
-					continue;
 				try
 				{
-					getFrame(set, offset)->loadImage(fileName + name);
+					loadImage(getFrame(set, offset), fileName + name, prefetcher, cache);
 					offset++;
 				}
 				catch (Exception &e)
@@ -254,12 +332,12 @@ SurfaceSet *ExtraSprites::loadSurfaceSet(SurfaceSet *set)
 		{
 			if (!subdivision)
 			{
-				getFrame(set, startFrame)->loadImage(fileName);
+				loadImage(getFrame(set, startFrame), fileName, prefetcher, cache);
 			}
 			else
 			{
 				Surface temp = Surface(_width, _height);
-				temp.loadImage(fileName);
+				loadImage(&temp, fileName, prefetcher, cache);
 				int xDivision = _width / _subX;
 				int yDivision = _height / _subY;
 				int frames = xDivision * yDivision;
@@ -306,6 +384,8 @@ Surface *ExtraSprites::getFrame(SurfaceSet *set, int index) const
 	if (frame)
 	{
 		Log(LOG_VERBOSE) << "Replacing frame: " << index << ", using index: " << indexWithOffset;
+		// pixels can be shared with other frames in the sprite atlas
+		frame->setOwnBuffer();
 		frame->clear();
 	}
 	else
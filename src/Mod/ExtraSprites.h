@@ -20,12 +20,15 @@
 #include "../Engine/Yaml.h"
 #include <string>
 #include <map>
+#include <vector>
 
 namespace OpenXcom
 {
 
 class Surface;
 class SurfaceSet;
+class ImagePrefetcher;
+class AssetCache;
 struct ModData;
 
 /**
@@ -43,6 +46,10 @@ private:
 	bool _loaded;
 
 	Surface *getFrame(SurfaceSet *set, int index) const;
+	/// Gets the image files in a folder.
+	static std::vector<std::string> getFolderImages(const std::string &folder);
+	/// Loads an image, prefetched if possible.
+	static void loadImage(Surface *surface, const std::string &filename, ImagePrefetcher *prefetcher, AssetCache *cache);
 public:
 	/// Creates a blank external sprite set.
 	ExtraSprites();
@@ -68,10 +75,12 @@ public:
 	bool isLoaded() const;
 	/// Checks if a filename is a valid image file.
 	static bool isImageFile(const std::string &filename);
+	/// Gets all image files used by this sprite.
+	std::vector<std::string> getImageFiles() const;
 	/// Load the external sprite into a surface.
-	Surface *loadSurface(Surface *surface);
+	Surface *loadSurface(Surface *surface, ImagePrefetcher *prefetcher = nullptr, AssetCache *cache = nullptr);
 	/// Load the external sprite into a surface set.
-	SurfaceSet *loadSurfaceSet(SurfaceSet *set);
+	SurfaceSet *loadSurfaceSet(SurfaceSet *set, ImagePrefetcher *prefetcher = nullptr, AssetCache *cache = nullptr);
 	/// Gets mod data that define this surface.
 	const ModData* getModOwner() { return _current; }
 };
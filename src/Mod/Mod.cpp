@@ -30,6 +30,9 @@
 #include "../Engine/Font.h"
 #include "../Engine/Surface.h"
 #include "../Engine/SurfaceSet.h"
+#include "../Engine/SurfaceAtlas.h"
+#include "../Engine/ImagePrefetcher.h"
+#include "../Engine/AssetCache.h"
 #include "../Engine/Music.h"
 #include "../Engine/GMCat.h"
 #include "../Engine/SoundSet.h"
@@ -53,6 +56,7 @@
 #include "../fmath.h"
 #include "../Engine/RNG.h"
 #include "../Engine/Options.h"
+#include "../Engine/Profiler.h"
 #include "../Battlescape/Pathfinding.h"
 #include "RuleCountry.h"
 #include "RuleRegion.h"
@@ -404,6 +408,14 @@ public:
 	{
 		updateConst("RuleList." + ModNameCurrent, (int)i);
 		_modCurr = i;
+		for (const auto& p : _modNames)
+		{
+			if (i == p.second)
+			{
+				setProfileMod(p.first);
+				break;
+			}
+		}
 	}
 
 	/// Get script values
@@ -414,7 +426,7 @@ public:
  * Creates an empty mod.
  */
 Mod::Mod() :
-	_inventoryOverlapsPaperdoll(false),
+	_spriteAtlas(nullptr), _imagePrefetcher(nullptr), _assetCache(nullptr), _rulesetCache(nullptr), _inventoryOverlapsPaperdoll(false),
 	_maxViewDistance(20), _maxDarknessToSeeUnits(9), _maxStaticLightDistance(16), _maxDynamicLightDistance(24), _enhancedLighting(0),
 	_costHireEngineer(0), _costHireScientist(0),
 	_costEngineer(0), _costScientist(0), _timePersonnel(0), _hireByCountryOdds(0), _hireByRegionOdds(0), _initialFunding(0),
@@ -591,6 +603,9 @@ Mod::Mod() :
  */
 Mod::~Mod()
 {
+	delete _imagePrefetcher;
+	delete _assetCache;
+	delete _rulesetCache;
 	delete _muteMusic;
 	delete _muteSound;
 	delete _globe;
@@ -608,6 +623,7 @@ Mod::~Mod()
 	{
 		delete pair.second;
 	}
+	delete _spriteAtlas;
 	for (auto& pair : _palettes)
 	{
 		delete pair.second;
@@ -842,6 +858,90 @@ T *Mod::getRule(const std::string &id, const std::string &name, const std::map<s
 	}
 }
 
+/**
+ * Gets a specific rule element by ID, using the hashed lookup
+ * once it is filled and the rule map while mods are still loading.
+ * @param id String ID of the rule element.
+ * @param name Human-readable name of the rule type.
+ * @param map Map associated to the rule type.
+ * @param lookup Hashed lookup associated to the rule type.
+ * @param error Throw an error if not found.
+ * @return Pointer to the rule element, or NULL if not found.
+ */
+template <typename T>
+T *Mod::getRule(const std::string &id, const std::string &name, const std::map<std::string, T*> &map, const RuleLookup<T> &lookup, bool error) const
+{
+	if (lookup.empty())
+	{
+		return getRule(id, name, map, error);
+	}
+	if (isEmptyRuleName(id))
+	{
+		return 0;
+	}
+	auto i = lookup.find(id);
+	if (i != lookup.end())
+	{
+		return i->second;
+	}
+	else
+	{
+		if (error)
+		{
+			throw Exception(name + " " + id + " not found");
+		}
+		return 0;
+	}
+}
+
+/**
+ * Fills the hashed lookup of a rule map. Keys are views
+ * of the map keys, so the map must outlive the lookup.
+ * @param map Map associated to the rule type.
+ * @param lookup Hashed lookup to fill.
+ */
+template <typename T>
+void Mod::buildRuleLookup(const std::map<std::string, T*> &map, RuleLookup<T> &lookup)
+{
+	lookup.clear();
+	lookup.reserve(map.size());
+	for (auto& pair : map)
+	{
+		if (pair.second != 0)
+		{
+			lookup.emplace(pair.first, pair.second);
+		}
+	}
+}
+
+/**
+ * Fills the hashed lookups of the rule types queried by name
+ * during gameplay. Must be called after all rules are loaded,
+ * as the rule maps can't change afterwards.
+ */
+void Mod::buildRuleLookups()
+{
+	buildRuleLookup(_countries, _countriesLookup);
+	buildRuleLookup(_regions, _regionsLookup);
+	buildRuleLookup(_facilities, _facilitiesLookup);
+	buildRuleLookup(_crafts, _craftsLookup);
+	buildRuleLookup(_craftWeapons, _craftWeaponsLookup);
+	buildRuleLookup(_items, _itemsLookup);
+	buildRuleLookup(_ufos, _ufosLookup);
+	buildRuleLookup(_terrains, _terrainsLookup);
+	buildRuleLookup(_skills, _skillsLookup);
+	buildRuleLookup(_soldiers, _soldiersLookup);
+	buildRuleLookup(_units, _unitsLookup);
+	buildRuleLookup(_alienRaces, _alienRacesLookup);
+	buildRuleLookup(_alienDeployments, _alienDeploymentsLookup);
+	buildRuleLookup(_armors, _armorsLookup);
+	buildRuleLookup(_invs, _invsLookup);
+	buildRuleLookup(_research, _researchLookup);
+	buildRuleLookup(_manufacture, _manufactureLookup);
+	buildRuleLookup(_soldierBonus, _soldierBonusLookup);
+	buildRuleLookup(_alienMissions, _alienMissionsLookup);
+}
+
 /**
  * Returns a specific font from the mod.
  * @param name Name of the font.
@@ -864,10 +964,19 @@ void Mod::lazyLoadSurface(const std::string &name)
 		auto i = _extraSprites.find(name);
 		if (i != _extraSprites.end())
 		{
+			bool loaded = false;
 			for (auto* extraSprites : i->second)
 			{
+				loaded |= !extraSprites->isLoaded();
 				loadExtraSprite(extraSprites);
 			}
+
+			// sets loaded after `loadAll` go to the atlas too
+			auto set = _sets.find(name);
+			if (loaded && _spriteAtlas && set != _sets.end())
+			{
+				_spriteAtlas->pack(set->second);
+			}
 		}
 	}
 }
@@ -883,6 +992,25 @@ Surface *Mod::getSurface(const std::string &name, bool error)
 	return getRule(name, "Sprite", _surfaces, error);
 }
 
+/**
+ * Returns the first of the surfaces that exists, for sprites
+ * looked up through a list of fallback names.
+ * @param names Names of the surfaces, in the order they are looked up.
+ * @param error Report an error if none of them exists.
+ * @return Pointer to the surface, or null.
+ */
+Surface *Mod::getFirstSurface(const std::vector<std::string> &names, bool error)
+{
+	for (size_t i = 0; i < names.size(); ++i)
+	{
+		if (Surface *surface = getSurface(names[i], error && i + 1 == names.size()))
+		{
+			return surface;
+		}
+	}
+	return nullptr;
+}
+
 /**
  * Returns a specific surface set from the mod.
  * @param name Name of the surface set.
@@ -894,6 +1022,79 @@ SurfaceSet *Mod::getSurfaceSet(const std::string &name, bool error)
 	return getRule(name, "Sprite Set", _sets, error);
 }
 
+/**
+ * Starts decoding the images of not yet loaded surfaces and surface sets
+ * on a background thread, so they're ready by the time someone asks for them.
+ * Only has an effect with lazy loading, otherwise everything is loaded already.
+ * @param names Names of the surfaces or surface sets, unknown ones are ignored.
+ * @param priority Bigger numbers are decoded first.
+ */
+void Mod::prefetchSurfaces(const std::vector<std::string> &names, int priority)
+{
+	if (!Options::lazyLoadResources || !Options::oxcePrefetchResources)
+	{
+		return;
+	}
+	for (const auto& name : names)
+	{
+		auto i = _extraSprites.find(name);
+		if (i == _extraSprites.end())
+		{
+			continue;
+		}
+		for (auto* extraSprites : i->second)
+		{
+			if (extraSprites->isLoaded())
+			{
+				continue;
+			}
+			if (!_imagePrefetcher)
+			{
+				_imagePrefetcher = new ImagePrefetcher();
+			}
+			for (const auto& file : extraSprites->getImageFiles())
+			{
+				// already decoded in an earlier run
+				if (_assetCache && _assetCache->contains(AssetCache::getFileKey(file)))
+				{
+					continue;
+				}
+				_imagePrefetcher->request(file, priority);
+			}
+		}
+	}
+}
+
+/**
+ * Starts decoding the first of the surfaces that exists, for sprites
+ * looked up through a list of fallback names. See prefetchSurfaces().
+ * @param names Names of the surfaces, in the order they are looked up.
+ * @param priority Bigger numbers are decoded first.
+ */
+void Mod::prefetchFirstSurface(const std::vector<std::string> &names, int priority)
+{
+	for (const auto& name : names)
+	{
+		if (_surfaces.find(name) != _surfaces.end() || _extraSprites.find(name) != _extraSprites.end())
+		{
+			prefetchSurfaces({ name }, priority);
+			return;
+		}
+	}
+}
+
+/**
+ * Drops the prefetched surfaces that were never asked for,
+ * so guessed sprites don't stay decoded in memory.
+ */
+void Mod::clearPrefetchedSurfaces()
+{
+	if (_imagePrefetcher)
+	{
+		_imagePrefetcher->clear();
+	}
+}
+
 /**
  * Returns a specific music from the mod.
  * @param name Name of the music.
@@ -2156,6 +2357,8 @@ static void throwModOnErrorHelper(const std::string& modId, const std::string& e
  */
 void Mod::loadAll()
 {
+	ProfileScope profile("Mod::loadAll");
+	ProfilePhase phase("Mod::loadAll");
 	ModScript parser{ _scriptGlobal, this };
 	const auto& mods = FileMap::getRulesets();
 
@@ -2197,6 +2400,7 @@ void Mod::loadAll()
 	}
 
 	Log(LOG_INFO) << "Pre-loading rulesets...";
+	ProfilePhase preloadPhase("Pre-loading rulesets");
 	// load rulesets that can affect loading vanilla resources
 	for (size_t i = 0; _modData.size() > i; ++i)
 	{
@@ -2212,10 +2416,40 @@ void Mod::loadAll()
 		}
 	}
 
+	preloadPhase.end();
+
+	if (Options::oxceAssetCache || Options::oxceRulesetCache)
+	{
+		// one cache per set of mods, anything else that changes the data is in the entry keys
+		Uint64 key = AssetCache::hash(OPENXCOM_VERSION_SHORT OPENXCOM_VERSION_GIT);
+		for (const auto& data : _modData)
+		{
+			key = AssetCache::hash(data.name, key);
+			key = AssetCache::hash(data.info->getVersion(), key);
+		}
+		std::string folder = Options::getUserFolder() + "cache/";
+		if (CrossPlatform::folderExists(folder) || CrossPlatform::createFolder(folder))
+		{
+			std::ostringstream suffix;
+			suffix << std::hex << key << ".dat";
+			AssetCache::prune(folder, suffix.str());
+			if (Options::oxceAssetCache)
+			{
+				_assetCache = new AssetCache(folder + "assets-" + suffix.str());
+			}
+			if (Options::oxceRulesetCache)
+			{
+				_rulesetCache = new AssetCache(folder + "rulesets-" + suffix.str());
+			}
+		}
+	}
+
 	Log(LOG_INFO) << "Loading vanilla resources...";
+	ProfilePhase vanillaPhase("Loading vanilla resources");
 	// vanilla resources load
 	_modCurrent = &_modData.at(0);
 	loadVanillaResources();
+	vanillaPhase.end();
 	_surfaceOffsetBasebits = _sets["BASEBITS.PCK"]->getMaxSharedFrames();
 	_surfaceOffsetBigobs = _sets["BIGOBS.PCK"]->getMaxSharedFrames();
 	_surfaceOffsetFloorob = _sets["FLOOROB.PCK"]->getMaxSharedFrames();
@@ -2227,9 +2461,11 @@ void Mod::loadAll()
 	_soundOffsetGeo = _sounds["GEO.CAT"]->getMaxSharedSounds();
 
 	Log(LOG_INFO) << "Loading rulesets...";
+	ProfilePhase rulesetsPhase("Loading rulesets");
 	// load rest rulesets
 	for (size_t i = 0; mods.size() > i; ++i)
 	{
+		ProfilePhase modPhase("Mod " + mods[i].first);
 		try
 		{
 			_modCurrent = &_modData.at(i);
@@ -2243,6 +2479,14 @@ void Mod::loadAll()
 		}
 	}
 	Log(LOG_INFO) << "Loading rulesets done.";
+	rulesetsPhase.end();
+
+	if (_rulesetCache)
+	{
+		// only needed while reading the rulesets
+		delete _rulesetCache;
+		_rulesetCache = nullptr;
+	}
 
 	//back master
 	_modCurrent = &_modData.at(0);
@@ -2286,10 +2530,14 @@ void Mod::loadAll()
 		}
 	}
 
-	loadExtraResources();
+	{
+		ProfilePhase extraPhase("Loading extra resources");
+		loadExtraResources();
+	}
 
 
 	Log(LOG_INFO) << "After load.";
+	ProfilePhase afterPhase("After load");
 	// cross link rule objects
 
 	afterLoadHelper("research", this, _research, &RuleResearch::afterLoad);
@@ -2453,10 +2701,36 @@ void Mod::loadAll()
 		}
 	}
 
+	afterPhase.end();
 	Log(LOG_INFO) << "Loading ended.";
 
-	sortLists();
-	modResources();
+	{
+		ProfilePhase sortPhase("Sorting lists");
+		sortLists();
+		buildRuleLookups();
+	}
+	{
+		ProfilePhase resourcesPhase("Modding resources");
+		modResources();
+	}
+
+	if (Options::oxceSpriteAtlas)
+	{
+		ProfilePhase atlasPhase("Packing sprite atlas");
+		_spriteAtlas = new SurfaceAtlas();
+		for (auto& pair : _sets)
+		{
+			_spriteAtlas->pack(pair.second);
+		}
+		Log(LOG_INFO) << "Sprite atlas: " << _spriteAtlas->getTotalFrames() << " frames, " << _spriteAtlas->getSharedFrames() << " duplicates, " << _spriteAtlas->getTotalBytes() / 1024 << " KB.";
+	}
+
+	if (_assetCache && !Options::lazyLoadResources)
+	{
+		// everything is loaded already, lazy loading keeps it until the end of the session
+		delete _assetCache;
+		_assetCache = nullptr;
+	}
 }
 
 /**
@@ -2710,7 +2984,16 @@ void Mod::loadConstants(const YAML::YamlNodeReader &reader)
  */
 void Mod::loadFile(const FileMap::FileRecord &filerec, ModScript &parsers)
 {
-	YAML::YamlRootNodeReader r = filerec.getYAML();
+	Uint64 snapshotKey = _rulesetCache ? AssetCache::getFileKey(filerec) : 0;
+	YAML::YamlRootNodeReader r = filerec.getYAML(_rulesetCache, snapshotKey);
+	if (_rulesetCache && !r.isSnapshot())
+	{
+		std::vector<Uint8> snapshot = r.saveSnapshot();
+		if (!snapshot.empty())
+		{
+			_rulesetCache->store(snapshotKey, snapshot.data(), snapshot.size());
+		}
+	}
 	YAML::YamlNodeReader reader = r.useIndex();
 
 	auto loadDocInfoHelper = [&](const char* nodeName)
@@ -3951,7 +4234,7 @@ SavedGame *Mod::newSave(GameDifficulty diff) const
  */
 RuleCountry *Mod::getCountry(const std::string &id, bool error) const
 {
-	return getRule(id, "Country", _countries, error);
+	return getRule(id, "Country", _countries, _countriesLookup, error);
 }
 
 /**
@@ -3991,7 +4274,7 @@ const std::vector<std::string> &Mod::getExtraGlobeLabelsList() const
  */
 RuleRegion *Mod::getRegion(const std::string &id, bool error) const
 {
-	return getRule(id, "Region", _regions, error);
+	return getRule(id, "Region", _regions, _regionsLookup, error);
 }
 
 /**
@@ -4011,7 +4294,7 @@ const std::vector<std::string> &Mod::getRegionsList() const
  */
 RuleBaseFacility *Mod::getBaseFacility(const std::string &id, bool error) const
 {
-	return getRule(id, "Facility", _facilities, error);
+	return getRule(id, "Facility", _facilities, _facilitiesLookup, error);
 }
 
 /**
@@ -4031,7 +4314,7 @@ const std::vector<std::string> &Mod::getBaseFacilitiesList() const
  */
 RuleCraft *Mod::getCraft(const std::string &id, bool error) const
 {
-	return getRule(id, "Craft", _crafts, error);
+	return getRule(id, "Craft", _crafts, _craftsLookup, error);
 }
 
 /**
@@ -4051,7 +4334,7 @@ const std::vector<std::string> &Mod::getCraftsList() const
  */
 RuleCraftWeapon *Mod::getCraftWeapon(const std::string &id, bool error) const
 {
-	return getRule(id, "Craft Weapon", _craftWeapons, error);
+	return getRule(id, "Craft Weapon", _craftWeapons, _craftWeaponsLookup, error);
 }
 
 /**
@@ -4103,7 +4386,7 @@ RuleItem *Mod::getItem(const std::string &id, bool error) const
 	{
 		return 0;
 	}
-	return getRule(id, "Item", _items, error);
+	return getRule(id, "Item", _items, _itemsLookup, error);
 }
 
 /**
@@ -4133,7 +4416,7 @@ RuleWeaponSet* Mod::getWeaponSet(const std::string& type, bool error) const
  */
 RuleUfo *Mod::getUfo(const std::string &id, bool error) const
 {
-	return getRule(id, "UFO", _ufos, error);
+	return getRule(id, "UFO", _ufos, _ufosLookup, error);
 }
 
 /**
@@ -4153,7 +4436,7 @@ const std::vector<std::string> &Mod::getUfosList() const
  */
 RuleTerrain *Mod::getTerrain(const std::string &name, bool error) const
 {
-	return getRule(name, "Terrain", _terrains, error);
+	return getRule(name, "Terrain", _terrains, _terrainsLookup, error);
 }
 
 /**
@@ -4193,7 +4476,7 @@ MapDataSet *Mod::getMapDataSet(const std::string &name)
  */
 RuleSkill *Mod::getSkill(const std::string &name, bool error) const
 {
-	return getRule(name, "Skill", _skills, error);
+	return getRule(name, "Skill", _skills, _skillsLookup, error);
 }
 
 /**
@@ -4203,7 +4486,7 @@ RuleSkill *Mod::getSkill(const std::string &name, bool error) const
  */
 RuleSoldier *Mod::getSoldier(const std::string &name, bool error) const
 {
-	return getRule(name, "Soldier", _soldiers, error);
+	return getRule(name, "Soldier", _soldiers, _soldiersLookup, error);
 }
 
 /**
@@ -4242,7 +4525,7 @@ const std::map<std::string, RuleCommendations *> &Mod::getCommendationsList() co
  */
 Unit *Mod::getUnit(const std::string &name, bool error) const
 {
-	return getRule(name, "Unit", _units, error);
+	return getRule(name, "Unit", _units, _unitsLookup, error);
 }
 
 /**
@@ -4252,7 +4535,7 @@ Unit *Mod::getUnit(const std::string &name, bool error) const
  */
 AlienRace *Mod::getAlienRace(const std::string &name, bool error) const
 {
-	return getRule(name, "Alien Race", _alienRaces, error);
+	return getRule(name, "Alien Race", _alienRaces, _alienRacesLookup, error);
 }
 
 /**
@@ -4314,7 +4597,7 @@ const std::vector<std::string>& Mod::getStartingConditionsList() const
  */
 AlienDeployment *Mod::getDeployment(const std::string &name, bool error) const
 {
-	return getRule(name, "Alien Deployment", _alienDeployments, error);
+	return getRule(name, "Alien Deployment", _alienDeployments, _alienDeploymentsLookup, error);
 }
 
 /**
@@ -4335,7 +4618,7 @@ const std::vector<std::string> &Mod::getDeploymentsList() const
  */
 Armor *Mod::getArmor(const std::string &name, bool error) const
 {
-	return getRule(name, "Armor", _armors, error);
+	return getRule(name, "Armor", _armors, _armorsLookup, error);
 }
 
 /**
@@ -4475,7 +4758,7 @@ std::map<std::string, RuleInventory*> *Mod::getInventories()
  */
 RuleInventory *Mod::getInventory(const std::string &id, bool error) const
 {
-	return getRule(id, "Inventory", _invs, error);
+	return getRule(id, "Inventory", _invs, _invsLookup, error);
 }
 
 /**
@@ -4504,7 +4787,7 @@ const std::vector<std::string> &Mod::getInvsList() const
  */
 RuleResearch *Mod::getResearch(const std::string &id, bool error) const
 {
-	return getRule(id, "Research", _research, error);
+	return getRule(id, "Research", _research, _researchLookup, error);
 }
 
 /**
@@ -4553,7 +4836,7 @@ const std::vector<std::string> &Mod::getResearchList() const
  */
 RuleManufacture *Mod::getManufacture (const std::string &id, bool error) const
 {
-	return getRule(id, "Manufacture", _manufacture, error);
+	return getRule(id, "Manufacture", _manufacture, _manufactureLookup, error);
 }
 
 /**
@@ -4572,7 +4855,7 @@ const std::vector<std::string> &Mod::getManufactureList() const
  */
 RuleSoldierBonus *Mod::getSoldierBonus(const std::string &id, bool error) const
 {
-	return getRule(id, "SoldierBonus", _soldierBonus, error);
+	return getRule(id, "SoldierBonus", _soldierBonus, _soldierBonusLookup, error);
 }
 
 /**
@@ -4643,7 +4926,7 @@ const UfoTrajectory *Mod::getUfoTrajectory(const std::string &id, bool error) co
  */
 const RuleAlienMission *Mod::getAlienMission(const std::string &id, bool error) const
 {
-	return getRule(id, "Alien Mission", _alienMissions, error);
+	return getRule(id, "Alien Mission", _alienMissions, _alienMissionsLookup, error);
 }
 
 /**
@@ -4947,6 +5230,15 @@ void Mod::sortLists()
 	}
 	sortIndex(_itemCategoriesIndex, _itemCategories, compareRule<RuleItemCategory>(this));
 	sortIndex(_itemsIndex, _items, compareRule<RuleItem>(this));
+	// dense item indexes for item containers, in list order
+	for (size_t i = 0; i < _itemsIndex.size(); ++i)
+	{
+		auto it = _items.find(_itemsIndex[i]);
+		if (it != _items.end())
+		{
+			it->second->setIndex(i);
+		}
+	}
 	sortIndex(_craftsIndex, _crafts, compareRule<RuleCraft>(this));
 	sortIndex(_facilitiesIndex, _facilities, compareRule<RuleBaseFacility>(this));
 	sortIndex(_researchIndex, _research, compareRule<RuleResearch>(this));
@@ -6113,7 +6405,7 @@ void Mod::loadExtraSprite(ExtraSprites *spritePack)
 			surface = i->second;
 		}
 
-		_surfaces[spritePack->getType()] = spritePack->loadSurface(surface);
+		_surfaces[spritePack->getType()] = spritePack->loadSurface(surface, _imagePrefetcher, _assetCache);
 		if (_statePalette)
 		{
 			if (spritePack->getType().find("_CPAL") == std::string::npos)
@@ -6131,7 +6423,7 @@ void Mod::loadExtraSprite(ExtraSprites *spritePack)
 			set = i->second;
 		}
 
-		_sets[spritePack->getType()] = spritePack->loadSurfaceSet(set);
+		_sets[spritePack->getType()] = spritePack->loadSurfaceSet(set, _imagePrefetcher, _assetCache);
 		if (_statePalette)
 		{
 			if (spritePack->getType().find("_CPAL") == std::string::npos)
@@ -6338,12 +6630,29 @@ Music* Mod::loadMusic(MusicFormat fmt, RuleMusic* rule, CatFile* adlibcat, CatFi
  * when used with the default TFTD mod, this function loops 4,194,304 times
  * (4 palettes, 4 tints, 4 levels of opacity, 256 colors, 256 comparisons per)
  * each additional tint in the rulesets will result in over a million iterations more.
+ * the result is kept in the asset cache, keyed by the palette and the tints.
  * @param pal the palette to base the lookup table on.
  */
 void Mod::createTransparencyLUT(Palette *pal)
 {
 	const SDL_Color* palColors = pal->getColors(0);
 	std::vector<Uint8> lookUpTable;
+
+	Uint64 key = 0;
+	size_t size = _transparencies.size() * TransparenciesPaletteColors * TransparenciesOpacityLevels;
+	if (_assetCache)
+	{
+		key = AssetCache::hash("TransparencyLUT");
+		key = AssetCache::hash(palColors, TransparenciesPaletteColors * sizeof(SDL_Color), key);
+		key = AssetCache::hash(_transparencies.data(), _transparencies.size() * sizeof(_transparencies[0]), key);
+		if (const Uint8 *cached = _assetCache->find(key, size))
+		{
+			lookUpTable.assign(cached, cached + size);
+			_transparencyLUTs.push_back(std::move(lookUpTable));
+			return;
+		}
+	}
+
 	// start with the color sets
 	lookUpTable.reserve(_transparencies.size() * TransparenciesPaletteColors * TransparenciesOpacityLevels);
 	for (const auto& tintLevels : _transparencies)
@@ -6383,6 +6692,10 @@ void Mod::createTransparencyLUT(Palette *pal)
 			}
 		}
 	}
+	if (_assetCache)
+	{
+		_assetCache->store(key, lookUpTable.data(), lookUpTable.size());
+	}
 	_transparencyLUTs.push_back(std::move(lookUpTable));
 }
 
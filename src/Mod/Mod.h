@@ -19,6 +19,7 @@
  */
 #include <map>
 #include <unordered_map>
+#include <string_view>
 #include <vector>
 #include <string>
 #include <bitset>
@@ -40,6 +41,9 @@ namespace OpenXcom
 
 class Surface;
 class SurfaceSet;
+class SurfaceAtlas;
+class ImagePrefetcher;
+class AssetCache;
 class Font;
 class Palette;
 class Music;
@@ -161,6 +165,9 @@ private:
 	std::map<std::string, Font*> _fonts;
 	std::map<std::string, Surface*> _surfaces;
 	std::map<std::string, SurfaceSet*> _sets;
+	SurfaceAtlas *_spriteAtlas;
+	ImagePrefetcher *_imagePrefetcher;
+	AssetCache *_assetCache, *_rulesetCache;
 	std::map<std::string, SoundSet*> _sounds;
 	std::map<std::string, Music*> _musics;
 	std::vector<Uint16> _voxelData;
@@ -213,6 +220,29 @@ private:
 	std::vector<RuleDamageType*> _damageTypes;
 	std::map<std::string, RuleMusic *> _musicDefs;
 
+	/// Hashed view of a rule map, keyed by the names the map owns.
+	template <typename T>
+	using RuleLookup = std::unordered_map<std::string_view, T*>;
+	RuleLookup<RuleCountry> _countriesLookup;
+	RuleLookup<RuleRegion> _regionsLookup;
+	RuleLookup<RuleBaseFacility> _facilitiesLookup;
+	RuleLookup<RuleCraft> _craftsLookup;
+	RuleLookup<RuleCraftWeapon> _craftWeaponsLookup;
+	RuleLookup<RuleItem> _itemsLookup;
+	RuleLookup<RuleUfo> _ufosLookup;
+	RuleLookup<RuleTerrain> _terrainsLookup;
+	RuleLookup<RuleSkill> _skillsLookup;
+	RuleLookup<RuleSoldier> _soldiersLookup;
+	RuleLookup<Unit> _unitsLookup;
+	RuleLookup<AlienRace> _alienRacesLookup;
+	RuleLookup<AlienDeployment> _alienDeploymentsLookup;
+	RuleLookup<Armor> _armorsLookup;
+	RuleLookup<RuleInventory> _invsLookup;
+	RuleLookup<RuleResearch> _researchLookup;
+	RuleLookup<RuleManufacture> _manufactureLookup;
+	RuleLookup<RuleSoldierBonus> _soldierBonusLookup;
+	RuleLookup<RuleAlienMission> _alienMissionsLookup;
+
 	RuleGlobe *_globe;
 	RuleConverter *_converter;
 	ModScriptGlobal *_scriptGlobal;
@@ -355,6 +385,14 @@ private:
 	/// Gets a ruleset element.
 	template <typename T>
 	T *getRule(const std::string &id, const std::string &name, const std::map<std::string, T*> &map, bool error) const;
+	/// Gets a ruleset element through its hashed lookup.
+	template <typename T>
+	T *getRule(const std::string &id, const std::string &name, const std::map<std::string, T*> &map, const RuleLookup<T> &lookup, bool error) const;
+	/// Fills the hashed lookup of a rule map.
+	template <typename T>
+	static void buildRuleLookup(const std::map<std::string, T*> &map, RuleLookup<T> &lookup);
+	/// Fills the hashed lookups of the most used rule types.
+	void buildRuleLookups();
 	/// Gets a random music. This is private to prevent access, use playMusic(name, true) instead.
 	Music *getRandomMusic(const std::string &name) const;
 	/// Gets a particular sound set. This is private to prevent access, use getSound(name, id) instead.
@@ -463,8 +501,16 @@ public:
 	Font *getFont(const std::string &name, bool error = true) const;
 	/// Gets a particular surface.
 	Surface *getSurface(const std::string &name, bool error = true);
+	/// Gets the first existing surface of a list of fallbacks.
+	Surface *getFirstSurface(const std::vector<std::string> &names, bool error = true);
 	/// Gets a particular surface set.
 	SurfaceSet *getSurfaceSet(const std::string &name, bool error = true);
+	/// Starts decoding surfaces in the background before they are needed.
+	void prefetchSurfaces(const std::vector<std::string> &names, int priority = 0);
+	/// Starts decoding the first existing surface of a list of fallbacks on a background thread.
+	void prefetchFirstSurface(const std::vector<std::string> &names, int priority = 0);
+	/// Drops the decoded surfaces nobody asked for.
+	void clearPrefetchedSurfaces();
 	/// Gets a particular music.
 	Music *getMusic(const std::string &name, bool error = true) const;
 	/// Gets the available music tracks.
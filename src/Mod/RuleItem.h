@@ -370,6 +370,7 @@ private:
 	ExperienceTrainingMode _experienceTrainingMode;
 	int _manaExperience;
 	int _listOrder, _maxRange, _minRange, _dropoff, _bulletSpeed, _explosionSpeed, _shotgunPellets;
+	int _index = -1;
 	int _shotgunBehaviorType, _shotgunSpread, _shotgunChoke;
 
 	std::map<std::string, std::string> _zombieUnitByArmorMale, _zombieUnitByArmorFemale, _zombieUnitByType;
@@ -827,6 +828,10 @@ public:
 	int getAttraction() const;
 	/// Get the list weight for this item.
 	int getListOrder() const;
+	/// Get the dense index of this item, in list order.
+	int getIndex() const { return _index; }
+	/// Set the dense index of this item.
+	void setIndex(int index) { _index = index; }
 	/// How fast does a projectile fired from this weapon travel?
 	int getBulletSpeed() const;
 	/// How fast does the explosion animation play?
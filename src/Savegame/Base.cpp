@@ -486,52 +486,80 @@ void Base::setEngineers(int engineers)
 	 _engineers = engineers;
 }
 
+/**
+ * Gathers the completed facilities of the base that can detect UFOs,
+ * so a detection pass can test every UFO against them.
+ * @param radars Radar list to fill.
+ */
+void Base::getRadars(BaseRadars &radars) const
+{
+	radars.radars.clear();
+	radars.radarMaxRange = 0;
+	radars.hyperwaveMaxRange = 0;
+
+	for (const auto* fac : _facilities)
+	{
+		if (fac->getBuildTime() != 0)
+		{
+			continue;
+		}
+		int range = fac->getRules()->getRadarRange();
+		int chance = fac->getRules()->getRadarChance();
+		bool hyperwave = fac->getRules()->isHyperwave();
+		if (hyperwave)
+		{
+			radars.hyperwaveMaxRange = std::max(radars.hyperwaveMaxRange, range);
+		}
+		else
+		{
+			radars.radarMaxRange = std::max(radars.radarMaxRange, range);
+		}
+		// the rest can't change the outcome, hyperwave ones still roll the dice
+		if (range > 0 || chance != 0 || hyperwave)
+		{
+			radars.radars.push_back(BaseRadars::Radar{ range, chance, hyperwave });
+		}
+	}
+	radars.maxRange = std::max(radars.radarMaxRange, radars.hyperwaveMaxRange);
+}
+
 /**
  * Returns if a certain target is covered by the base's
  * radar range, taking in account the range and chance.
  * @param target Pointer to target to compare.
  * @param alreadyDedected Was ufo already detected, `true` mean we track it without probability.
+ * @param radars Radar facilities of the base, from getRadars().
+ * @param distance Distance to the target, in nautical miles.
  * @return 0 - not detected, 1 - detected by conventional radar, 2 - detected by hyper-wave decoder.
  */
-UfoDetection Base::detect(const Ufo *target, const SavedGame *save, bool alreadyTracked) const
+UfoDetection Base::detect(const Ufo *target, const SavedGame *save, bool alreadyTracked, const BaseRadars &radars, int distance) const
 {
-	auto distance = XcomDistance(getDistance(target));
 	auto hyperwave = false;
-	auto hyperwave_max_range = 0;
+	auto hyperwave_max_range = radars.hyperwaveMaxRange;
 	auto hyperwave_chance = 0;
-	auto radar_max_range = 0;
+	auto radar_max_range = radars.radarMaxRange;
 	auto radar_chance = 0;
 
-	for (const auto* fac : _facilities)
+	if (radars.maxRange >= distance)
 	{
-		if (fac->getBuildTime() != 0)
-		{
-			continue;
-		}
-		if (fac->getRules()->getRadarRange() >= distance)
+		for (const auto& radar : radars.radars)
 		{
-			int radarChance = fac->getRules()->getRadarChance();
-			if (fac->getRules()->isHyperwave())
+			if (radar.range >= distance)
 			{
-				if (radarChance == 100 || RNG::percent(radarChance))
+				if (radar.hyperwave)
 				{
-					hyperwave = true;
+					if (radar.chance == 100 || RNG::percent(radar.chance))
+					{
+						hyperwave = true;
+					}
+					hyperwave_chance += radar.chance;
+				}
+				else
+				{
+					radar_chance += radar.chance;
 				}
-				hyperwave_chance += radarChance;
-			}
-			else
-			{
-				radar_chance += radarChance;
 			}
 		}
-		if (fac->getRules()->isHyperwave())
-		{
-			hyperwave_max_range = std::max(hyperwave_max_range, fac->getRules()->getRadarRange());
-		}
-		else
-		{
-			radar_max_range = std::max(radar_max_range, fac->getRules()->getRadarRange());
-		}
 	}
 
 	auto detectionChance = 0;
@@ -1695,14 +1723,7 @@ int Base::getUsedContainment(int prisonType, bool onlyExternal) const
 		return total;
 	}
 
-	for (const auto& pair : *_items->getContents())
-	{
-		rule = pair.first;
-		if (rule->isAlien() && rule->getPrisonType() == prisonType)
-		{
-			total += pair.second;
-		}
-	}
+	total += _items->getTotalAliens(prisonType);
 	return total;
 }
 
@@ -103,6 +103,22 @@ struct BaseSumDailyRecovery
 	float SickBayAbsoluteBonus = 0.0f;
 };
 
+/**
+ * Radar facilities of a base, gathered once per detection pass.
+ */
+struct BaseRadars
+{
+	struct Radar
+	{
+		int range, chance;
+		bool hyperwave;
+	};
+	std::vector<Radar> radars;
+	int radarMaxRange = 0;
+	int hyperwaveMaxRange = 0;
+	int maxRange = 0;
+};
+
 /**
  * Represents a player base on the globe.
  * Bases can contain facilities, personnel, crafts and equipment.
@@ -178,8 +194,10 @@ public:
 	int getEngineers() const;
 	/// Sets the base's engineers.
 	void setEngineers(int engineers);
+	/// Gathers the base's completed radar facilities.
+	void getRadars(BaseRadars &radars) const;
 	/// Checks if a target is detected by the base's radar.
-	UfoDetection detect(const Ufo *target, const SavedGame *save, bool alreadyTracked) const;
+	UfoDetection detect(const Ufo *target, const SavedGame *save, bool alreadyTracked, const BaseRadars &radars, int distance) const;
 	/// Gets the base's available soldiers.
 	int getAvailableSoldiers(bool checkCombatReadiness = false, bool includeWounded = false) const;
 	/// Gets the base's total soldiers.
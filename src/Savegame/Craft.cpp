@@ -1136,6 +1136,15 @@ bool Craft::isTakingOff() const
 	return _takeoff == 60;
 }
 
+/**
+ * Is the craft neither moving nor taking off?
+ * Such craft don't change in think().
+ */
+bool Craft::isStationary() const
+{
+	return _dest == 0 && _takeoff == 0;
+}
+
 /**
  * Checks the condition of all the craft's systems
  * to define its new status (eg. when arriving at base).
@@ -1180,12 +1189,11 @@ void Craft::checkup()
  * Returns if a certain target is detected by the craft's
  * radar, taking in account the range and chance.
  * @param target Pointer to target to compare.
+ * @param distance Distance to the target, in nautical miles.
  * @return True if it's detected, False otherwise.
  */
-UfoDetection Craft::detect(const Ufo *target, const SavedGame *save, bool alreadyTracked) const
+UfoDetection Craft::detect(const Ufo *target, const SavedGame *save, bool alreadyTracked, int distance) const
 {
-	auto distance = XcomDistance(getDistance(target));
-
 	auto detectionChance = 0;
 	auto detectionType = DETECTION_NONE;
 
@@ -1494,13 +1502,14 @@ bool Craft::areOnlyPermittedSoldierTypesOnboard(const RuleStartingCondition* sc)
 
 /**
  * Checks if there are enough required items onboard.
+ * @param mod Mod to look up the items in.
  * @return True if the craft has enough required items.
  */
-bool Craft::areRequiredItemsOnboard(const std::map<std::string, int>& requiredItems) const
+bool Craft::areRequiredItemsOnboard(const std::map<std::string, int>& requiredItems, const Mod *mod) const
 {
 	for (const auto& mapItem : requiredItems)
 	{
-		if (_items->getItem(mapItem.first) < mapItem.second)
+		if (_items->getItem(mapItem.first, mod) < mapItem.second)
 		{
 			return false;
 		}
@@ -1510,12 +1519,13 @@ bool Craft::areRequiredItemsOnboard(const std::map<std::string, int>& requiredIt
 
 /**
  * Destroys given required items.
+ * @param mod Mod to look up the items in.
  */
-void Craft::destroyRequiredItems(const std::map<std::string, int>& requiredItems)
+void Craft::destroyRequiredItems(const std::map<std::string, int>& requiredItems, const Mod *mod)
 {
 	for (const auto& mapItem : requiredItems)
 	{
-		_items->removeItem(mapItem.first, mapItem.second);
+		_items->removeItem(mapItem.first, mapItem.second, mod);
 	}
 }
 
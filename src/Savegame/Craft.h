@@ -258,11 +258,13 @@ public:
 	/// Returns the crew to their base (using transfers).
 	void evacuateCrew(const Mod *mod);
 	/// Checks if a target is detected by the craft's radar.
-	UfoDetection detect(const Ufo *target, const SavedGame *save, bool alreadyTracked) const;
+	UfoDetection detect(const Ufo *target, const SavedGame *save, bool alreadyTracked, int distance) const;
 	/// Handles craft logic.
 	bool think();
 	/// Is the craft about to take off?
 	bool isTakingOff() const;
+	/// Is the craft neither moving nor taking off?
+	bool isStationary() const;
 	/// Does a craft full checkup.
 	void checkup();
 	/// Consumes the craft's fuel.
@@ -294,9 +296,9 @@ public:
 	/// Checks if there are only permitted soldier types onboard.
 	bool areOnlyPermittedSoldierTypesOnboard(const RuleStartingCondition* sc) const;
 	/// Checks if there are enough required items onboard.
-	bool areRequiredItemsOnboard(const std::map<std::string, int>& requiredItems) const;
+	bool areRequiredItemsOnboard(const std::map<std::string, int>& requiredItems, const Mod *mod) const;
 	/// Destroys given required items.
-	void destroyRequiredItems(const std::map<std::string, int>& requiredItems);
+	void destroyRequiredItems(const std::map<std::string, int>& requiredItems, const Mod *mod);
 	/// Checks item limits.
 	bool areTooManyItemsOnboard();
 	/// Checks if there are enough pilots onboard.
@@ -17,8 +17,11 @@
  * along with OpenXcom.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "ItemContainer.h"
+#include <algorithm>
+#include <cassert>
 #include "../Mod/Mod.h"
 #include "../Mod/RuleItem.h"
+#include "../Engine/Exception.h"
 
 namespace OpenXcom
 {
@@ -26,7 +29,7 @@ namespace OpenXcom
 /**
  * Initializes an item container with no contents.
  */
-ItemContainer::ItemContainer()
+ItemContainer::ItemContainer() : _totalQuantity(0), _totalSize(0.0), _totalsValid(false)
 {
 }
 
@@ -45,14 +48,18 @@ void ItemContainer::load(const YAML::YamlNodeReader& reader, const Mod* mod)
 {
 	if (!reader || !reader.isMap())
 		return;
-	_qty.clear();
+	clear();
+	std::string name; // reused, to not allocate for every item
 	for (const auto& item : reader.children())
 	{
-		std::string name = item.readKey<std::string>();
+		name.assign(item.key());
 		const auto* type = mod->getItem(name);
 		if (type)
 		{
-			_qty[type] = item.readVal<int>();
+			int qty = item.readVal<int>();
+			Entry &slot = getSlot(type);
+			_totalQuantity += qty - slot.second;
+			slot.second = qty;
 		}
 		else
 		{
@@ -78,6 +85,85 @@ void ItemContainer::save(YAML::YamlNodeWriter writer) const
 		writer.write(writer.saveString(pair.first), pair.second);
 }
 
+/**
+ * Gets the slot of an item, creating it if the item
+ * is not in the container yet.
+ * @param item Item type.
+ * @return Reference to the slot.
+ */
+ItemContainer::Entry &ItemContainer::getSlot(const RuleItem* item)
+{
+	int index = item->getIndex();
+	if (index < 0)
+	{
+		throw Exception("Item " + item->getType() + " has no index");
+	}
+	auto found = _qty._positions.find(index);
+	if (found != _qty._positions.end())
+	{
+		return _qty._slots[found->second];
+	}
+
+	auto& slots = _qty._slots;
+	if (slots.size() != _qty._size)
+	{
+		slots.erase(std::remove_if(slots.begin(), slots.end(), [](const Entry& slot) { return !slot.first; }), slots.end());
+	}
+	auto pos = std::lower_bound(slots.begin(), slots.end(), index, [](const Entry& slot, int i) { return slot.first->getIndex() < i; });
+	pos = slots.insert(pos, Entry(item, 0));
+	++_qty._size;
+	for (size_t i = 0; i < slots.size(); ++i)
+	{
+		_qty._positions[slots[i].first->getIndex()] = i;
+	}
+	return *pos;
+}
+
+/**
+ * Gets the slot of an item.
+ * @param item Item type.
+ * @return Pointer to the slot, or null if the item is not in the container.
+ */
+ItemContainer::Entry *ItemContainer::findSlot(const RuleItem* item)
+{
+	auto found = _qty._positions.find(item->getIndex());
+	return found != _qty._positions.end() ? &_qty._slots[found->second] : nullptr;
+}
+
+/**
+ * Gets the slot of an item.
+ * @param item Item type.
+ * @return Pointer to the slot, or null if the item is not in the container.
+ */
+const ItemContainer::Entry *ItemContainer::findSlot(const RuleItem* item) const
+{
+	auto found = _qty._positions.find(item->getIndex());
+	return found != _qty._positions.end() ? &_qty._slots[found->second] : nullptr;
+}
+
+/**
+ * Removes an item amount from a slot,
+ * emptying the slot if nothing is left.
+ * @param slot Slot of the item.
+ * @param qty Item quantity.
+ */
+void ItemContainer::removeFromSlot(Entry &slot, int qty)
+{
+	if (qty < slot.second)
+	{
+		slot.second -= qty;
+		_totalQuantity -= qty;
+	}
+	else
+	{
+		_totalQuantity -= slot.second;
+		_qty._positions.erase(slot.first->getIndex());
+		slot = Entry(nullptr, 0);
+		--_qty._size;
+	}
+	_totalsValid = false;
+}
+
 /**
  * Adds an item amount to the container.
  * @param id Item ID.
@@ -87,7 +173,9 @@ void ItemContainer::addItem(const RuleItem* item, int qty)
 {
 	if (item)
 	{
-		_qty[item] += qty;
+		getSlot(item).second += qty;
+		_totalQuantity += qty;
+		_totalsValid = false;
 	}
 }
 
@@ -95,27 +183,15 @@ void ItemContainer::addItem(const RuleItem* item, int qty)
  * Removes an item amount from the container.
  * @param id Item ID.
  * @param qty Item quantity.
+ * @param mod Mod to look up the item in.
  */
-void ItemContainer::removeItem(const std::string &id, int qty)
+void ItemContainer::removeItem(const std::string &id, int qty, const Mod *mod)
 {
 	if (Mod::isEmptyRuleName(id))
 	{
 		return;
 	}
-	auto it = std::find_if(_qty.begin(), _qty.end(), [&](auto& pair) { return pair.first->getType() == id; });
-	if (it == _qty.end())
-	{
-		return;
-	}
-
-	if (qty < it->second)
-	{
-		it->second -= qty;
-	}
-	else
-	{
-		_qty.erase(it);
-	}
+	removeItem(mod->getItem(id), qty);
 }
 
 /**
@@ -127,44 +203,29 @@ void ItemContainer::removeItem(const RuleItem* item, int qty)
 {
 	if (item)
 	{
-		auto it = _qty.find(item);
-		if (it == _qty.end())
+		Entry *slot = findSlot(item);
+		if (!slot)
 		{
 			return;
 		}
 
-		if (qty < it->second)
-		{
-			it->second -= qty;
-		}
-		else
-		{
-			_qty.erase(it);
-		}
+		removeFromSlot(*slot, qty);
 	}
 }
 
 /**
  * Returns the quantity of an item in the container.
  * @param id Item ID.
+ * @param mod Mod to look up the item in.
  * @return Item quantity.
  */
-int ItemContainer::getItem(const std::string &id) const
+int ItemContainer::getItem(const std::string &id, const Mod *mod) const
 {
 	if (Mod::isEmptyRuleName(id))
 	{
 		return 0;
 	}
-
-	auto it = std::find_if(_qty.begin(), _qty.end(), [&](auto& pair) { return pair.first->getType() == id; });
-	if (it == _qty.end())
-	{
-		return 0;
-	}
-	else
-	{
-		return it->second;
-	}
+	return getItem(mod->getItem(id));
 }
 
 /**
@@ -176,14 +237,14 @@ int ItemContainer::getItem(const RuleItem* item) const
 {
 	if (item)
 	{
-		auto it = _qty.find(item);
-		if (it == _qty.end())
+		const Entry *slot = findSlot(item);
+		if (!slot)
 		{
 			return 0;
 		}
 		else
 		{
-			return it->second;
+			return slot->second;
 		}
 	}
 	else
@@ -192,18 +253,44 @@ int ItemContainer::getItem(const RuleItem* item) const
 	}
 }
 
+/**
+ * Recalculates the totals derived from the contents,
+ * if they changed since the last time.
+ */
+void ItemContainer::updateTotals() const
+{
+	if (_totalsValid)
+	{
+		return;
+	}
+	_totalSize = 0;
+	_totalAliens.clear();
+	for (const auto& pair : _qty)
+	{
+		_totalSize += pair.first->getSize() * pair.second;
+		if (pair.first->isAlien())
+		{
+			_totalAliens[pair.first->getPrisonType()] += pair.second;
+		}
+	}
+	_totalsValid = true;
+}
+
 /**
  * Returns the total quantity of the items in the container.
  * @return Total item quantity.
  */
 int ItemContainer::getTotalQuantity() const
 {
+#ifndef NDEBUG
 	int total = 0;
 	for (const auto& pair : _qty)
 	{
 		total += pair.second;
 	}
-	return total;
+	assert(total == _totalQuantity && "Item container quantity out of sync");
+#endif
+	return _totalQuantity;
 }
 
 /**
@@ -212,19 +299,27 @@ int ItemContainer::getTotalQuantity() const
  */
 double ItemContainer::getTotalSize() const
 {
-	double total = 0;
-	for (const auto& pair : _qty)
-	{
-		total += pair.first->getSize() * pair.second;
-	}
-	return total;
+	updateTotals();
+	return _totalSize;
+}
+
+/**
+ * Returns the total quantity of live aliens of a prison type in the container.
+ * @param prisonType Prison type.
+ * @return Total alien quantity.
+ */
+int ItemContainer::getTotalAliens(int prisonType) const
+{
+	updateTotals();
+	auto it = _totalAliens.find(prisonType);
+	return it != _totalAliens.end() ? it->second : 0;
 }
 
 /**
  * Returns all the items currently contained within.
  * @return List of contents.
  */
-const std::map<const RuleItem*, int> *ItemContainer::getContents() const
+const ItemContainer::Contents *ItemContainer::getContents() const
 {
 	return &_qty;
 }
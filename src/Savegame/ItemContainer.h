@@ -19,6 +19,9 @@
  */
 #include <string>
 #include <map>
+#include <unordered_map>
+#include <vector>
+#include <iterator>
 #include "../Engine/Yaml.h"
 
 namespace OpenXcom
@@ -34,8 +37,74 @@ class RuleItem;
  */
 class ItemContainer
 {
+public:
+	using Entry = std::pair<const RuleItem*, int>;
+
+	/**
+	 * Contents of a container, the items held sorted by item index.
+	 * Removing an item only empties its slot, so the others never move
+	 * and iterators to them stay valid, empty slots are dropped
+	 * when a new item is added.
+	 */
+	class Contents
+	{
+		std::vector<Entry> _slots;
+		std::unordered_map<int, size_t> _positions;
+		size_t _size = 0;
+
+		friend class ItemContainer;
+	public:
+		class const_iterator
+		{
+			const Entry *_curr, *_end;
+
+			void skip() { while (_curr != _end && !_curr->first) ++_curr; }
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Entry;
+			using difference_type = std::ptrdiff_t;
+			using pointer = const Entry*;
+			using reference = const Entry&;
+
+			const_iterator(const Entry *curr, const Entry *end) : _curr(curr), _end(end) { skip(); }
+
+			reference operator*() const { return *_curr; }
+			pointer operator->() const { return _curr; }
+			const_iterator& operator++() { ++_curr; skip(); return *this; }
+			const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+			bool operator==(const const_iterator& other) const { return _curr == other._curr; }
+			bool operator!=(const const_iterator& other) const { return _curr != other._curr; }
+		};
+		using iterator = const_iterator;
+
+		/// Gets the first item.
+		const_iterator begin() const { return const_iterator(_slots.data(), _slots.data() + _slots.size()); }
+		/// Gets the end of the items.
+		const_iterator end() const { return const_iterator(_slots.data() + _slots.size(), _slots.data() + _slots.size()); }
+		/// Check if have any item.
+		bool empty() const { return _size == 0; }
+		/// Gets the number of different items.
+		size_t size() const { return _size; }
+	};
+
 private:
-	std::map<const RuleItem*, int> _qty;
+	Contents _qty;
+	int _totalQuantity;
+	///totals derived from the contents, refreshed on first use after a change
+	mutable double _totalSize;
+	mutable std::map<int, int> _totalAliens;
+	mutable bool _totalsValid;
+
+	/// Gets the slot of an item, creating it if needed.
+	Entry &getSlot(const RuleItem* item);
+	/// Gets the slot of an item, if the item is in the container.
+	Entry *findSlot(const RuleItem* item);
+	/// Gets the slot of an item, if the item is in the container.
+	const Entry *findSlot(const RuleItem* item) const;
+	/// Removes an item amount from a slot.
+	void removeFromSlot(Entry &slot, int qty);
+	/// Recalculates the cached totals if the contents changed.
+	void updateTotals() const;
 public:
 	/// Creates an empty item container.
 	ItemContainer();
@@ -50,23 +119,25 @@ public:
 	/// Adds an item to the container.
 	void addItem(const RuleItem* item, int qty = 1);
 	/// Removes an item from the container.
-	void removeItem(const std::string &id, int qty = 1);
+	void removeItem(const std::string &id, int qty, const Mod *mod);
 	/// Removes an item from the container.
 	void removeItem(const RuleItem* item, int qty = 1);
 	/// Gets an item in the container.
-	int getItem(const std::string &id) const;
+	int getItem(const std::string &id, const Mod *mod) const;
 	/// Gets an item in the container.
 	int getItem(const RuleItem* item) const;
 	/// Gets the total quantity of items in the container.
 	int getTotalQuantity() const;
 	/// Gets the total size of items in the container.
 	double getTotalSize() const;
+	/// Gets the total quantity of live aliens of a prison type in the container.
+	int getTotalAliens(int prisonType) const;
 	/// Check if have any item
 	bool empty() const { return _qty.empty(); }
 	/// Clear all content.
-	void clear() { _qty.clear(); }
+	void clear() { _qty._slots.clear(); _qty._positions.clear(); _qty._size = 0; _totalQuantity = 0; _totalsValid = false; }
 	/// Gets all the items in the container.
-	const std::map<const RuleItem*, int> *getContents() const;
+	const Contents *getContents() const;
 };
 
 }
@@ -994,6 +994,25 @@ const std::vector<std::string>& Soldier::getArmorLayers(Armor *customArmor) cons
 	throw Exception("Layered armor sprite definition (" + armor->getType() + ") not found!");
 }
 
+/**
+ * Returns the names of the inventory sprites (paperdolls) for armor without layers,
+ * in the order they are looked up: the look variants first, then the plain sprite.
+ * @param look Name of the armor's inventory sprite.
+ * @return Sprite names, only the last one has to exist.
+ */
+std::vector<std::string> Soldier::getSpriteInventoryNames(const std::string &look) const
+{
+	const std::string gender = _gender == GENDER_MALE ? "M" : "F";
+	std::vector<std::string> names;
+	for (int i = 0; i <= RuleSoldier::LookVariantBits; ++i)
+	{
+		names.push_back(look + gender + std::to_string((int)_look + (_lookVariant & (RuleSoldier::LookVariantMask >> i)) * 4) + ".SPK");
+	}
+	names.push_back(look + ".SPK");
+	names.push_back(look);
+	return names;
+}
+
 /**
 * Gets the soldier's original armor (before replacement).
 * @return Pointer to armor data.
@@ -181,6 +181,8 @@ public:
 	void setArmor(Armor *armor, bool resetCustomDeployment = false);
 	/// Gets the armor layers (sprite names).
 	const std::vector<std::string>& getArmorLayers(Armor *customArmor = nullptr) const;
+	/// Gets the names of the inventory sprites to try for this soldier, in order.
+	std::vector<std::string> getSpriteInventoryNames(const std::string &look) const;
 	/// Gets the soldier's original armor (before replacement).
 	Armor *getReplacedArmor() const;
 	/// Backs up the soldier's original armor (before replacement).
@@ -119,15 +119,35 @@ int main(int argc, char *argv[])
 	CrossPlatform::processArgs(argc, argv);
 	if (!Options::init())
 		return EXIT_SUCCESS;
+	if (!Options::checkBenchmarkSave())
+		return EXIT_FAILURE;
 	std::ostringstream title;
 	title << "OpenXcom " << OPENXCOM_VERSION_SHORT << OPENXCOM_VERSION_GIT;
 	Options::baseXResolution = Options::displayWidth;
 	Options::baseYResolution = Options::displayHeight;
 
+	if (Options::getBenchmarkStartupRuns() > 0 || Options::getBenchmarkLoadRuns() > 0)
+	{
+		// load the data without opening a window or a sound device
+		SDL_putenv((char *)"SDL_VIDEODRIVER=dummy");
+		SDL_putenv((char *)"SDL_AUDIODRIVER=dummy");
+	}
+
 	game = new Game(title.str());
 	State::setGamePtr(game);
-	game->setState(new StartState);
-	game->run();
+	if (Options::getBenchmarkStartupRuns() > 0)
+	{
+		StartState::benchmark(game, Options::getBenchmarkStartupRuns());
+	}
+	else if (Options::getBenchmarkLoadRuns() > 0)
+	{
+		StartState::benchmarkLoad(game, Options::getLoadThisSave(), Options::getBenchmarkLoadRuns());
+	}
+	else
+	{
+		game->setState(new StartState);
+		game->run();
+	}
 
 	bool startUpdate = game->getUpdateFlag();
 